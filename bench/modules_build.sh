@@ -0,0 +1,172 @@
+#!/bin/bash
+# Compares the clean build wall time of a template generated C++ package that
+# includes a header library with the same package on the C++20 modules
+# template ('cmake_tool create --modules'), where the library is a module.
+#
+# Usage: bench/modules_build.sh [SOURCES] [RUNS]
+#   SOURCES  number of small .cpp files using the library (default 32)
+#   RUNS     clean builds timed per template (default 3)
+#
+# Needs CMake 3.28 or newer, Ninja and a compiler with module support
+# (e.g. GCC 14 or Clang 16).
+
+set -e
+
+sources=${1:-32}
+runs=${2:-3}
+jobs=$(nproc)
+
+cmake_version=$(cmake --version | awk 'NR == 1 { print $3 }')
+if [ "$(printf '%s\n3.28\n' "$cmake_version" | sort -V | head -n 1)" != "3.28" ]; then
+    echo "C++20 modules need CMake 3.28 or newer, found $cmake_version" >&2
+    exit 1
+fi
+if ! command -v ninja > /dev/null; then
+    echo "C++20 modules need the Ninja generator, ninja was not found" >&2
+    exit 1
+fi
+
+repo_dir=$(cd "$(dirname "$0")/.." && pwd)
+template_dir="$repo_dir/share/cmake_tool"
+work_dir=$(mktemp -d /tmp/cmake_tool_modules_bench.XXXXXX)
+trap 'rm -rf "$work_dir"' EXIT
+
+# the library both packages share, pulling in the standard headers ours do
+library_body()
+{
+    cat <<'SOURCE'
+namespace shapes
+{
+inline std::vector<std::string> split(const std::string &text)
+{
+    std::vector<std::string> words;
+    std::istringstream stream(text);
+    std::string word;
+    while (stream >> word)
+    {
+        words.push_back(word);
+    }
+    return words;
+}
+
+inline int count_unique(const std::string &text)
+{
+    std::map<std::string, int> counts;
+    for (const std::string &word : split(text))
+    {
+        ++counts[word];
+    }
+    return static_cast<int>(counts.size());
+}
+
+template <typename T>
+T largest(std::vector<T> values)
+{
+    std::sort(values.begin(), values.end());
+    return values.empty() ? T() : values.back();
+}
+}
+SOURCE
+}
+
+# writes SOURCES users of the library and a main calling all of them
+write_sources()
+{
+    local package=$1 use_library=$2
+    for i in $(seq 1 "$sources"); do
+        cat > "$package/src/unit_$i.cpp" <<SOURCE
+$use_library
+
+int unit_$i(int value)
+{
+    return shapes::count_unique("unit $i value " + std::to_string(value)) + shapes::largest<int>({value, $i});
+}
+SOURCE
+    done
+    {
+        for i in $(seq 1 "$sources"); do
+            echo "int unit_$i(int value);"
+        done
+        echo "int main()"
+        echo "{"
+        echo "    int total = 0;"
+        for i in $(seq 1 "$sources"); do
+            echo "    total += unit_$i($i);"
+        done
+        echo "    return total > 0 ? 0 : 1;"
+        echo "}"
+    } > "$package/src/main.cpp"
+}
+
+# header package: the C++ template at the same language standard as the modules one
+headers="$work_dir/headers"
+mkdir -p "$headers/src" "$headers/include"
+sed -e 's/%%PROJECT_NAME%%/headers/g' -e 's/%%UNITY_BUILD%%/OFF/g' -e 's/%%UNITY_BATCH_SIZE%%/8/g' \
+    -e 's/%%PCH%%/OFF/g' -e 's/%%PROFILE%%/none/g' -e 's/%%CXX_STANDARD%%/20/g' \
+    "$template_dir/c++_application.cmake.in" > "$headers/CMakeLists.txt"
+{
+    echo "#pragma once"
+    echo
+    printf '#include <%s>\n' algorithm map sstream string vector
+    echo
+    library_body
+} > "$headers/include/shapes.hpp"
+write_sources "$headers" '#include "shapes.hpp"'
+
+# modules package: the library is a module interface unit compiled once
+modules="$work_dir/modules"
+mkdir -p "$modules/src" "$modules/include"
+sed -e 's/%%PROJECT_NAME%%/modules/g' -e 's/%%CXX_STANDARD%%/20/g' "$template_dir/c++_modules.cmake.in" > "$modules/CMakeLists.txt"
+{
+    echo "module;"
+    echo
+    printf '#include <%s>\n' algorithm map sstream string vector
+    echo
+    echo "export module shapes;"
+    echo
+    library_body | sed 's/^namespace shapes$/export namespace shapes/'
+} > "$modules/src/shapes.cppm"
+write_sources "$modules" $'#include <string>\n\nimport shapes;'
+
+# prints the wall seconds of a clean build after a clean configure, fails
+# with the tool's output on stderr when the configure or the build fails
+time_build()
+{
+    local package=$1
+    local build_dir="$work_dir/build"
+    local log="$work_dir/build.log"
+    rm -rf "$build_dir"
+    if ! cmake -S "$package" -B "$build_dir" -G Ninja -DCMAKE_BUILD_TYPE=Release > "$log" 2>&1; then
+        cat "$log" >&2
+        echo "configure failed: $package" >&2
+        return 1
+    fi
+    local start end
+    start=$(date +%s%N)
+    if ! cmake --build "$build_dir" -j "$jobs" > "$log" 2>&1; then
+        cat "$log" >&2
+        echo "build failed: $package" >&2
+        return 1
+    fi
+    end=$(date +%s%N)
+    if [ ! -x "$build_dir/$(basename "$package")" ]; then
+        echo "build did not produce $build_dir/$(basename "$package")" >&2
+        return 1
+    fi
+    awk -v start="$start" -v end="$end" 'BEGIN { printf "%.3f\n", (end - start) / 1e9 }'
+}
+
+echo "Sample packages: $sources sources using one library, $runs clean builds per template, ninja -j$jobs"
+printf "    %-24s %10s %10s %10s\n" "template" "mean" "min" "max"
+for package in "$headers" "$modules"; do
+    name=$(basename "$package")
+    samples=()
+    for run in $(seq 1 "$runs"); do
+        # set -e only stops at a failed substitution in a plain assignment
+        sample=$(time_build "$package")
+        samples+=("$sample")
+    done
+    printf '%s\n' "${samples[@]}" | awk -v name="$name" '
+        { sum += $1; if (NR == 1 || $1 < min) min = $1; if ($1 > max) max = $1 }
+        END { printf "    %-24s %9.2fs %9.2fs %9.2fs\n", name, sum / NR, min, max }'
+done
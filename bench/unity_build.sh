@@ -0,0 +1,109 @@
+#!/bin/bash
+# Compares the build wall time of a template generated C++ package with and
+# without unity build.
+#
+# Usage: bench/unity_build.sh [SOURCES] [RUNS] [BATCH_SIZE]
+#   SOURCES     number of small .cpp files in the sample package (default 64)
+#   RUNS        clean builds timed per mode (default 3)
+#   BATCH_SIZE  sources per unity translation unit (default 8)
+
+set -e
+
+sources=${1:-64}
+runs=${2:-3}
+batch_size=${3:-8}
+jobs=$(nproc)
+
+repo_dir=$(cd "$(dirname "$0")/.." && pwd)
+template="$repo_dir/share/cmake_tool/c++_application.cmake.in"
+work_dir=$(mktemp -d /tmp/cmake_tool_unity_bench.XXXXXX)
+trap 'rm -rf "$work_dir"' EXIT
+
+# sample package: every source pulls in a few standard headers, like ours do
+package="$work_dir/sample"
+mkdir -p "$package/src" "$package/include"
+sed -e 's/%%PROJECT_NAME%%/sample/g' -e 's/%%UNITY_BUILD%%/OFF/g' -e "s/%%UNITY_BATCH_SIZE%%/$batch_size/g" \
+    -e 's/%%PCH%%/OFF/g' -e 's/%%PROFILE%%/none/g' -e 's/%%CXX_STANDARD%%/11/g' "$template" > "$package/CMakeLists.txt"
+for i in $(seq 1 "$sources"); do
+    cat > "$package/src/unit_$i.cpp" <<SOURCE
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::map<std::string, std::vector<int>> table_$i;
+}
+
+int unit_$i(int value)
+{
+    std::vector<int> &values = table_$i[std::to_string(value)];
+    values.push_back(value);
+    std::sort(values.begin(), values.end());
+    return static_cast<int>(values.size());
+}
+SOURCE
+done
+{
+    for i in $(seq 1 "$sources"); do
+        echo "int unit_$i(int value);"
+    done
+    echo "int main()"
+    echo "{"
+    echo "    int total = 0;"
+    for i in $(seq 1 "$sources"); do
+        echo "    total += unit_$i($i);"
+    done
+    echo "    return total == $sources ? 0 : 1;"
+    echo "}"
+} > "$package/src/main.cpp"
+
+# prints the wall seconds of a clean configure and build, fails with the
+# tool's output on stderr when the configure or the build fails
+time_build()
+{
+    local build_dir="$work_dir/build"
+    local log="$work_dir/build.log"
+    rm -rf "$build_dir"
+    mkdir -p "$build_dir"
+    if ! (cd "$build_dir" && cmake "$package" -DCMAKE_BUILD_TYPE=Release "$@") > "$log" 2>&1; then
+        cat "$log" >&2
+        echo "configure failed: cmake $*" >&2
+        return 1
+    fi
+    local start end
+    start=$(date +%s%N)
+    if ! make -C "$build_dir" -j"$jobs" > "$log" 2>&1; then
+        cat "$log" >&2
+        echo "build failed: $*" >&2
+        return 1
+    fi
+    end=$(date +%s%N)
+    if [ ! -x "$build_dir/sample" ]; then
+        echo "build did not produce $build_dir/sample: $*" >&2
+        return 1
+    fi
+    awk -v start="$start" -v end="$end" 'BEGIN { printf "%.3f\n", (end - start) / 1e9 }'
+}
+
+echo "Sample package: $((sources + 1)) sources, $runs clean builds per mode, make -j$jobs"
+printf "    %-24s %10s %10s %10s\n" "mode" "mean" "min" "max"
+for mode in "off" "unity"; do
+    if [ "$mode" = "off" ]; then
+        args="-DCMAKE_UNITY_BUILD=OFF"
+        name="no unity"
+    else
+        args="-DCMAKE_UNITY_BUILD=ON -DCMAKE_UNITY_BUILD_BATCH_SIZE=$batch_size"
+        name="unity (batch $batch_size)"
+    fi
+    samples=()
+    for run in $(seq 1 "$runs"); do
+        # set -e only stops at a failed substitution in a plain assignment
+        sample=$(time_build $args)
+        samples+=("$sample")
+    done
+    printf '%s\n' "${samples[@]}" | awk -v name="$name" '
+        { sum += $1; if (NR == 1 || $1 < min) min = $1; if ($1 > max) max = $1 }
+        END { printf "    %-24s %9.2fs %9.2fs %9.2fs\n", name, sum / NR, min, max }'
+done
@@ -25,7 +25,7 @@ _complete_cmake_tool()
     arg=${COMP_WORDS[COMP_CWORD]}
 
     if [[ $COMP_CWORD == 1 ]]; then
-        opts="help create build clean delete run list reset attach detach tar untar"
+        opts="help create build sync-sources pch-suggest add-component clean delete run list stats reset attach detach tar untar cache-server"
         COMPREPLY=($(compgen -W "$opts" -- ${arg}))
     elif [[ $COMP_CWORD == 2 ]]; then
         case ${COMP_WORDS[1]} in
@@ -39,7 +39,7 @@ _complete_cmake_tool()
                 fi
                 COMPREPLY=($(compgen -W "$opts" -- ${arg}))
                 ;;
-            build|clean|delete)
+            build|sync-sources|clean|delete)
                 local cur="${COMP_WORDS[COMP_CWORD]}"
                 if [[ "$cur" == -* ]]; then
                     # 用户输入 "-" 字符
@@ -60,6 +60,33 @@ _complete_cmake_tool()
                 opts="-b --basename -p --path"
                 COMPREPLY=($(compgen -W "$opts" -- ${arg}))
                 ;;
+            pch-suggest)
+                if [[ "${COMP_WORDS[COMP_CWORD]}" == -* ]]; then
+                    opts="-l --log -f --force -n --top -w --write"
+                else
+                    opts=$(cmake_tool list --basename 2> /dev/null)
+                fi
+                COMPREPLY=($(compgen -W "$opts" -- ${arg}))
+                ;;
+            add-component)
+                if [[ "${COMP_WORDS[COMP_CWORD]}" == -* ]]; then
+                    opts="-l --log -f --force"
+                    COMPREPLY=($(compgen -W "$opts" -- ${arg}))
+                elif [[ $COMP_CWORD == 2 ]]; then
+                    opts=$(cmake_tool list --basename 2> /dev/null)
+                    COMPREPLY=($(compgen -W "$opts" -- ${arg}))
+                fi
+                ;;
+            stats)
+                if [[ "${COMP_WORDS[COMP_CWORD-1]}" == "-s" || "${COMP_WORDS[COMP_CWORD-1]}" == "--sort" ]]; then
+                    opts="cpu rss time io"
+                elif [[ "${COMP_WORDS[COMP_CWORD]}" == -* ]]; then
+                    opts="-l --log -f --force -s --sort -st --stages"
+                else
+                    opts=$(cmake_tool list --basename 2> /dev/null)
+                fi
+                COMPREPLY=($(compgen -W "$opts" -- ${arg}))
+                ;;
             create|attach|detach|tar|untar)
                 local cur="${COMP_WORDS[COMP_CWORD]}"
                 local prev="${COMP_WORDS[COMP_CWORD-1]}"
@@ -135,11 +162,17 @@ _complete_cmake_tool()
                     cd $current_path
                 fi
                 ;;
-            build|clean|delete)
+            build|sync-sources|clean|delete)
                 local cur="${COMP_WORDS[COMP_CWORD]}"
                 if [[ "$cur" == -* ]]; then
                     # 用户输入 "-" 字符
                     opts="-l --log -f --force -a --all"
+                    if [[ ${COMP_WORDS[1]} != "sync-sources" ]]; then
+                        opts="$opts -br --build-root"
+                    fi
+                    if [[ ${COMP_WORDS[1]} == "build" ]]; then
+                        opts="$opts -rs --resume -w --watch -c --cache -r --remote-cache -j --jobs -cj --configure-jobs -bj --build-jobs -cf --configs -tc --toolchains -bm --bench -bn --bench-runs -ac --analyze-compile-time -u --unity -pch --pch -g --generator -pf --profile -pgo --pgo -tr --train -pr --priority -cpu --cpus -mp --max-pressure"
+                    fi
                     COMPREPLY=($(compgen -W "$opts" -- ${arg}))
                 else
                     if [[ ${COMP_WORDS[2]:0:1} == "/" ]]; then
@@ -156,6 +189,33 @@ _complete_cmake_tool()
                 opts="-b --basename -p --path"
                 COMPREPLY=($(compgen -W "$opts" -- ${arg}))
                 ;;
+            pch-suggest)
+                if [[ "${COMP_WORDS[COMP_CWORD]}" == -* ]]; then
+                    opts="-l --log -f --force -n --top -w --write"
+                else
+                    opts=$(cmake_tool list --basename 2> /dev/null)
+                fi
+                COMPREPLY=($(compgen -W "$opts" -- ${arg}))
+                ;;
+            add-component)
+                if [[ "${COMP_WORDS[COMP_CWORD]}" == -* ]]; then
+                    opts="-l --log -f --force"
+                    COMPREPLY=($(compgen -W "$opts" -- ${arg}))
+                elif [[ $COMP_CWORD == 2 ]]; then
+                    opts=$(cmake_tool list --basename 2> /dev/null)
+                    COMPREPLY=($(compgen -W "$opts" -- ${arg}))
+                fi
+                ;;
+            stats)
+                if [[ "${COMP_WORDS[COMP_CWORD-1]}" == "-s" || "${COMP_WORDS[COMP_CWORD-1]}" == "--sort" ]]; then
+                    opts="cpu rss time io"
+                elif [[ "${COMP_WORDS[COMP_CWORD]}" == -* ]]; then
+                    opts="-l --log -f --force -s --sort -st --stages"
+                else
+                    opts=$(cmake_tool list --basename 2> /dev/null)
+                fi
+                COMPREPLY=($(compgen -W "$opts" -- ${arg}))
+                ;;
             create|attach|detach|tar|untar)
                 local cur="${COMP_WORDS[COMP_CWORD]}"
                 local prev="${COMP_WORDS[COMP_CWORD-1]}"
@@ -168,7 +228,7 @@ _complete_cmake_tool()
                             candidate=($(compgen -W "$opts" -- ${arg}))
                             ;;
                         create)
-                            opts="-l --log"
+                            opts="-l --log -t --type -ly --layout -m --modules -u --unity -pch --pch -wb --with-bench -wt --with-tracing -pf --profile -std --std -tp --template"
                             candidate=($(compgen -W "$opts" -- ${arg}))
                             ;;
                         attach)
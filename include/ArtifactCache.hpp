@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Local artifact cache keyed by a fingerprint of the package inputs, with an
+// optional remote tier speaking plain HTTP GET/PUT:
+//   <cache>/ac/<fingerprint>  first line: sha256 of the artifact, then the
+//                             installed files relative to the package path
+//   <cache>/cas/<sha256>      the installed files as a tar.gz stream
+class ArtifactCache
+{
+public:
+    ArtifactCache();
+    ~ArtifactCache();
+
+    void setCacheDirectory(const std::string &cache_dir);
+    void setRemoteUrl(const std::string &remote_url);
+    void setRemoteJobs(size_t remote_jobs);
+
+    const std::string &getCacheDirectory() const
+    {
+        return m_cacheDir;
+    }
+
+    const std::string &getRemoteUrl() const
+    {
+        return m_remoteUrl;
+    }
+
+    std::string computeFingerprint(const std::string &package_path, const std::string &build_inputs) const;
+    bool restore(const std::string &fingerprint, const std::string &package_path, const std::string &build_path);
+    bool store(const std::string &fingerprint, const std::string &package_path, const std::string &manifest_path);
+    void prefetch(const std::vector<std::string> &fingerprints);
+    void flush();
+
+    static std::string getDefaultCacheDirectory();
+
+private:
+    std::string _acPath(const std::string &fingerprint) const;
+    std::string _casPath(const std::string &digest) const;
+    bool _readEntry(const std::string &fingerprint, std::string &digest, std::vector<std::string> &files) const;
+    bool _fetchRemote(const std::string &fingerprint);
+    bool _uploadRemote(const std::string &fingerprint);
+    void _uploadWorker();
+    void _warning(const std::string &message);
+
+    std::string m_cacheDir;
+    std::string m_remoteUrl;
+    size_t m_remoteJobs{4};
+
+    std::mutex m_mutex;
+    std::condition_variable m_uploadCondition;
+    std::deque<std::string> m_uploadQueue;
+    std::vector<std::thread> m_uploaders;
+    bool m_uploadDone{false};
+    size_t m_uploadCount{0};
+    size_t m_uploadFailures{0};
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct BenchmarkEntry
+{
+    std::string name;
+    std::string program_path;
+    double compile_seconds{0.0};
+    std::uint64_t binary_size{0};
+    std::vector<double> run_seconds;
+    bool failed{false};
+};
+
+// Times a program built by several variants and prints a comparison table with
+// 95% confidence intervals (Student's t) of the mean runtime.
+class BenchmarkReport
+{
+public:
+    void addEntry(const BenchmarkEntry &entry);
+    void run(const std::string &program_args, size_t runs);
+    void print() const;
+
+    static void summarize(const std::vector<double> &samples, double &mean, double &half_width);
+
+private:
+    std::vector<BenchmarkEntry> m_entries;
+    size_t m_runs{0};
+};
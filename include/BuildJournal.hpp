@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "BuildScheduler.hpp"
+
+// Build plan and per-package state of the last `build -a`, kept next to
+// create.info so an interrupted run can be resumed. One line per package in
+// dependency order: "<state>\t<package path>". The file is rewritten through a
+// rename on every state change, a killed build leaves it consistent.
+class BuildJournal
+{
+public:
+    bool isOpen() const
+    {
+        return !m_journalPath.empty();
+    }
+
+    void create(const std::string &journal_path);
+    bool load(const std::string &journal_path);
+    void close();
+
+    void addPackages(const std::vector<std::string> &package_paths);
+    void setState(const std::string &package_path, BuildJobState state);
+    std::vector<std::string> getUnfinishedPackages() const;
+
+private:
+    struct Entry
+    {
+        std::string package_path;
+        BuildJobState state;
+    };
+
+    void _save() const;
+
+    std::string m_journalPath;
+    std::vector<Entry> m_entries;
+    mutable std::mutex m_mutex;
+};
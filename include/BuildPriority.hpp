@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+enum class BuildPriorityClass
+{
+    BACKGROUND,  // nice 19, idle I/O class, new jobs wait while the machine is under pressure
+    NORMAL,
+    HIGH,        // nice -5, best effort I/O at the highest level, needs CAP_SYS_NICE
+};
+
+// Scheduling class of the build. It is applied to the cmake_tool process before
+// any thread or child is started, so every compiler and linker inherits it.
+class BuildPriority
+{
+public:
+    static bool parse(const std::string &name, BuildPriorityClass &priority);
+    static const char *getName(BuildPriorityClass priority);
+
+    static bool apply(BuildPriorityClass priority, const std::vector<int> &cpus);
+    static bool parseCpuList(const std::string &cpu_list, std::vector<int> &cpus);
+
+    // "some avg10" of /proc/pressure/<resource>: the share of the last 10 seconds
+    // in which at least one task stalled on the resource, in percent
+    static bool readPressure(const std::string &resource, double &avg10);
+};
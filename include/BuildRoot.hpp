@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+
+// Resolves the build tree of a package. Without a root directory packages are
+// built in '<package>/build/'; with one, in '<root>/<name>-<path hash>/', which
+// lets object files live on a fast local disk or tmpfs. When the volume of the
+// root runs short of free space, the least recently built trees are evicted.
+class BuildRoot
+{
+public:
+    void setRootDirectory(const std::string &root_dir);
+    void setMinFreeBytes(std::uint64_t min_free_bytes);
+
+    const std::string &getRootDirectory() const
+    {
+        return m_rootDir;
+    }
+
+    std::string getBuildPath(const std::string &package_path) const;
+    void markUsed(const std::string &package_path);
+    void evict(const std::set<std::string> &keep_build_paths);
+
+    static std::string getDefaultRootDirectory();
+    static std::uint64_t parseSize(const std::string &size_string);
+
+private:
+    std::uint64_t _getFreeBytes() const;
+
+    std::string m_rootDir;
+    std::uint64_t m_minFreeBytes{0};
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utils/SystemUtils.h"
+
+enum class BuildStage
+{
+    CONFIGURE,
+    BUILD,
+    INSTALL,
+};
+
+enum class BuildStageResult
+{
+    FAILED,
+    SUCCEEDED,
+    CACHED,  // the job was restored from the artifact cache, skip the remaining stages
+};
+
+enum class BuildJobState
+{
+    PENDING,
+    RUNNING,
+    SUCCEEDED,
+    CACHED,
+    FAILED,
+    SKIPPED,
+};
+
+struct BuildJob
+{
+    std::string package_path;
+    std::string build_path;
+    std::string variant;
+    std::string fingerprint;
+    std::vector<size_t> dependencies;
+
+    BuildJobState state{BuildJobState::PENDING};
+    size_t next_stage{0};
+    double stage_seconds[3]{0.0, 0.0, 0.0};
+    ProcessUsage stage_usage[3];   // resources of the child processes of every stage
+};
+
+// Runs the configure, build and install stages of many packages as a pipeline.
+// Every stage has its own concurrency limit, so configure of upcoming packages
+// overlaps with compiling the others. A job only starts configuring once all
+// its dependencies are installed.
+class BuildScheduler
+{
+public:
+    typedef std::function<BuildStageResult(BuildJob &job, BuildStage stage)> StageRunner;
+    // asked before a job starts configuring, false holds back new jobs and polls again later
+    typedef std::function<bool()> AdmissionCheck;
+
+    BuildScheduler(size_t configure_jobs, size_t build_jobs, size_t install_jobs = 1);
+
+    size_t addJob(const std::string &package_path, const std::string &build_path, const std::string &variant = "");
+    void addDependency(size_t job_index, size_t dependency_index);
+    void setAdmissionCheck(const AdmissionCheck &check);
+    void run(const StageRunner &runner);
+
+    std::vector<BuildJob> &getJobs()
+    {
+        return m_jobs;
+    }
+
+    static const char *getStageName(BuildStage stage);
+    static const char *getStateName(BuildJobState state);
+
+private:
+    bool _isReady(const BuildJob &job) const;
+    void _skipBlockedJobs();
+
+    std::vector<BuildJob> m_jobs;
+    size_t m_stageLimits[3];
+    size_t m_stageRunning[3]{0, 0, 0};
+    AdmissionCheck m_admissionCheck;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
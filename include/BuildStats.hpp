@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BuildScheduler.hpp"
+
+// the latest build of a package variant with the resources its child processes used
+struct BuildRecord
+{
+    std::string package_path;
+    std::string variant;
+    std::string state;
+    std::int64_t time{0};
+    double stage_seconds[3]{0.0, 0.0, 0.0};
+    ProcessUsage stage_usage[3];
+    double prefetch_seconds{0.0};        // cold source reads done by the prefetch instead of the compilers
+    std::uint64_t prefetch_bytes{0};
+
+    double getSeconds() const;
+    ProcessUsage getUsage() const;
+};
+
+// Build records kept next to create.info as "build.stats", one line per package
+// and variant: "<state>\t<time>\t<configure>\t<build>\t<install>\t<variant>\t<path>\t<prefetch>",
+// every stage as "seconds,user,sys,max_rss_kb,blocks_in,blocks_out", the
+// prefetch as "seconds,cold_bytes".
+class BuildStats
+{
+public:
+    bool load(const std::string &stats_path);
+    bool save() const;
+
+    void addJob(const BuildJob &job, double prefetch_seconds = 0.0, std::uint64_t prefetch_bytes = 0);
+
+    const std::vector<BuildRecord> &getRecords() const
+    {
+        return m_records;
+    }
+
+private:
+    std::string m_statsPath;
+    std::vector<BuildRecord> m_records;
+};
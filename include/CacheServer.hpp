@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+// A tiny HTTP artifact store with the same layout as ArtifactCache:
+//   GET/HEAD/PUT /cas/<sha256>  content addressed blobs (verified on PUT)
+//   GET/HEAD/PUT /ac/<sha256>   fingerprint -> artifact entries
+class CacheServer
+{
+public:
+    CacheServer(const std::string &storage_dir, const std::string &bind_address = "127.0.0.1", int port = 8080);
+    ~CacheServer();
+
+    bool run();
+    void stop();
+
+private:
+    void _handleConnection(int fd);
+    void _sendStatus(int fd, int status, const std::string &reason);
+    void _handleGet(int fd, const std::string &file_path, bool head_only);
+    void _handlePut(int fd, const std::string &kind, const std::string &key, const std::string &headers, const std::string &body_prefix);
+
+    std::string m_storageDir;
+    std::string m_bindAddress;
+    int m_port{8080};
+    int m_listenFd{-1};
+    std::atomic<bool> m_running{false};
+    std::atomic<int> m_activeConnections{0};
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+struct CompileTimeEntry
+{
+    std::uint64_t total_us{0};
+    size_t count{0};
+};
+
+// Aggregates the -ftime-trace JSON files of many build trees into the most
+// expensive headers, template instantiations and translation units. Traces are
+// read with a streaming parser, only the aggregates are kept in memory.
+class CompileTimeAnalyzer
+{
+public:
+    bool addTraceFile(const std::string &trace_path, const std::string &unit_name);
+    size_t addBuildTree(const std::string &build_path, const std::string &label);
+    void print(size_t top_count) const;
+
+    size_t getTraceCount() const
+    {
+        return m_traceCount;
+    }
+
+private:
+    void _addEvent(const std::string &name, const std::string &detail, std::uint64_t duration_us, const std::string &unit_name);
+    static void _printTop(const char *title, const std::map<std::string, CompileTimeEntry> &entries, size_t top_count);
+
+    std::map<std::string, CompileTimeEntry> m_headers;
+    std::map<std::string, CompileTimeEntry> m_templates;
+    std::map<std::string, CompileTimeEntry> m_units;
+
+    std::uint64_t m_frontendUs{0};
+    std::uint64_t m_backendUs{0};
+    std::uint64_t m_templateUs{0};
+    size_t m_traceCount{0};
+    size_t m_failedCount{0};
+};
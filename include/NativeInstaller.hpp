@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils/SystemUtils.h"
+
+// Replaces `make install`: CMake installs into a staging tree inside the build
+// directory (DESTDIR), then only files that differ from the installed ones are
+// synced to their real destinations. A file is written next to its destination
+// (reflink, copy_file_range or plain copy) and renamed over it, so a running
+// program never sees a half-written binary.
+class NativeInstaller
+{
+public:
+    struct Stats
+    {
+        size_t updated{0};
+        size_t cloned{0};
+        size_t unchanged{0};
+        size_t failed{0};
+        std::uint64_t bytes_written{0};
+    };
+
+    explicit NativeInstaller(const std::string &build_path);
+
+    bool install(const std::string &log_path = "", ProcessUsage *usage = nullptr);
+
+    const Stats &getStats() const
+    {
+        return m_stats;
+    }
+
+private:
+    bool _stage(const std::string &log_path, ProcessUsage *usage);
+    void _readInstallFiles(std::vector<std::string> &install_files);
+    bool _syncFile(const std::string &staged_path, const std::string &install_path);
+    bool _syncSymlink(const std::string &staged_path, const std::string &install_path);
+    bool _copyToTemporary(const std::string &staged_path, const std::string &temp_path, bool &cloned);
+
+    std::string m_buildPath;
+    std::string m_stagePath;
+    Stats m_stats;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Dependency graph between registered packages. A package depends on another
+// registered package when its CMake files call find_package() with that
+// package's name (case-insensitive).
+class PackageGraph
+{
+public:
+    void addPackage(const std::string &package_path);
+    void resolve();
+
+    bool contains(const std::string &package_path) const;
+    const std::set<std::string> &getDependencies(const std::string &package_path) const;
+    std::set<std::string> getDependents(const std::string &package_path) const;
+    std::vector<std::string> sort(const std::vector<std::string> &package_paths) const;
+
+private:
+    static std::set<std::string> _scanFindPackages(const std::string &package_path);
+
+    std::vector<std::string> m_packagePaths;
+    std::map<std::string, std::set<std::string>> m_dependencies;
+    std::map<std::string, std::set<std::string>> m_dependents;
+};
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
+#include "ArtifactCache.hpp"
+#include "BuildJournal.hpp"
+#include "BuildPriority.hpp"
+#include "BuildRoot.hpp"
+#include "BuildScheduler.hpp"
+#include "PackageGraph.hpp"
+#include "TemplateEngine.hpp"
+
 #include "utils/StringUtils.h"
 
 enum class PackageType
@@ -10,6 +19,9 @@ enum class PackageType
     CMAKE_UNKNOWN,
     CMAKE_CPP_PACKAGE,
     CMAKE_C_PACKAGE,
+    CMAKE_CPP_LIBRARY,
+    CMAKE_C_LIBRARY,
+    CMAKE_CPP_RT_PACKAGE,
 };
 
 struct Package
@@ -29,6 +41,18 @@ struct Package
         {
             type = PackageType::CMAKE_C_PACKAGE;
         }
+        else if (StringUtils::equals(pkg_type, "LIB"))
+        {
+            type = PackageType::CMAKE_CPP_LIBRARY;
+        }
+        else if (StringUtils::equals(pkg_type, "CLIB"))
+        {
+            type = PackageType::CMAKE_C_LIBRARY;
+        }
+        else if (StringUtils::equals(pkg_type, "RT"))
+        {
+            type = PackageType::CMAKE_CPP_RT_PACKAGE;
+        }
     }
 
     Package(const std::string& pkg_path, const PackageType& pkg_type)
@@ -41,6 +65,49 @@ struct Package
     PackageType type{PackageType::CMAKE_UNKNOWN};
 };
 
+// an isolated build of a package with its own build tree, install prefix and cmake arguments
+struct BuildVariant
+{
+    std::string name;
+    std::vector<std::string> cmake_args;
+    std::string environment;    // prepended to the configure command, e.g. "CC=gcc-12 CXX=g++-12"
+    bool install{true};         // false for build trees only kept for inspection
+};
+
+struct CreateOptions
+{
+    size_t unity_batch_size{0};  // sources per unity (jumbo) translation unit, 0 = no unity build
+    bool pch{false};             // C++ only: generate include/pch.hpp and precompile it
+    std::string profile{"none"}; // default build profile of cmake_tool_profile.cmake
+    bool modules{false};         // C++ only: C++20 named module skeleton, needs CMake 3.28 and Ninja
+    bool modular{false};         // C++ only: one object library per src/<component>/, see 'cmake_tool add-component'
+    bool bench{false};           // bench/ with the microbenchmark harness, built as bin/<name>_bench
+    bool tracing{false};         // C++ only: header-only scoped-zone tracer include/trace.hpp
+    std::string standard;        // language standard of the package, e.g. "17", empty = the one of the template
+    std::string template_dir;    // custom template tree rendered into the package instead of the built-in one
+};
+
+struct BuildOptions
+{
+    bool use_cache{false};
+    std::string remote_cache_url;
+    size_t jobs{0};             // compile job budget shared by all packages, 0 = number of CPUs
+    size_t configure_jobs{2};   // packages configured at the same time
+    size_t build_jobs{1};       // packages compiled at the same time
+    bool native_install{true};  // sync changed files from a staging tree instead of 'make install'
+    bool prefetch{true};        // warm the page cache with the sources while the first packages configure
+    std::vector<BuildVariant> variants;  // empty = one build installing into the package
+    std::string bench_program;  // program of bin/ timed for every variant after the build, with its arguments
+    size_t bench_runs{10};
+    size_t analyze_compile_time{0};  // report the N most expensive headers, templates and sources, 0 = off
+    std::vector<std::string> cmake_args;  // passed to the configure of every package, e.g. "-DCMAKE_UNITY_BUILD=ON"
+    std::string profile;        // build profile of cmake_tool_profile.cmake, empty = the one of the package
+    std::string pgo_train;      // "PROGRAM ARGS" of bin/ trained on, non-empty builds with profile guided optimization
+    std::string generator;      // CMake generator of new build trees, empty = Ninja for C++ modules, else CMake's default
+    BuildPriorityClass priority{BuildPriorityClass::NORMAL};
+    double max_pressure{20.0};  // background builds hold back new jobs above this PSI cpu or io avg10, in percent
+};
+
 class PackageTool
 {
 
@@ -50,16 +117,28 @@ public:
 
     void setLog(bool enable_log);
     void setForce(bool enable_force);
+    void setCreateOptions(const CreateOptions &create_options);
+    void setBuildOptions(const BuildOptions &build_options);
+    void setBuildRoot(const std::string &root_dir, std::uint64_t min_free_bytes = 0);
+    static bool isValidProfile(const std::string &profile);
     void createPackage(const std::string &package_path, const std::string &package_type, bool quiet = false);
     void buildPackage(const std::string &package_path, bool quiet = false);
+    void buildPackages(const std::vector<std::string> &package_paths, bool quiet = false);
     void buildAllPackages(bool quiet = false);
+    void resumeBuild(bool quiet = false);
+    void watchPackages(const std::vector<std::string> &package_paths, bool quiet = false);
+    void syncSources(const std::vector<std::string> &package_paths, bool quiet = false);
+    void syncAllSources(bool quiet = false);
+    void suggestPch(const std::string &package_path, size_t max_count = 20, bool write = false);
+    void addComponent(const std::string &package_path, const std::string &component_name);
     void cleanPackage(const std::string &package_path, bool quiet = false);
     void cleanAllPackages(bool quiet = false);
     void deletePackage(const std::string &package_path, bool quiet = false);
     void deleteAllPackages(bool quiet = false);
     void listPackages(bool basename_only = false, bool path_only = false);
+    void showStats(const std::vector<std::string> &package_paths, const std::string &sort_key = "cpu", bool show_stages = false);
     void resetInfo();
-    void runPackage(const std::string &package_path, const std::string &program_name, const std::vector<std::string> &program_args);
+    void runPackage(const std::string &package_path, const std::string &program_name, const std::vector<std::string> &program_args, const std::string &variant = "");
     void attachPackage(const std::string &package_path, bool quiet = false);
     void attachPackagesFromFile(const std::string &file_path, bool quiet = false);
     void detachPackage(const std::string &package_path, bool quiet = false);
@@ -71,14 +150,23 @@ public:
 private:
     void _createPackage(const std::string &package_path, PackageType package_type, bool quiet = false);
     void _buildPackage(const std::string &package_path, bool quiet = false);
+    std::vector<BuildJob> _buildPackages(const std::vector<std::string> &package_paths, bool quiet = false);
+    std::vector<BuildJob> _buildPgoPackages(const std::vector<std::string> &package_paths, bool quiet = false);
     void _buildAllPackages(bool quiet = false);
+    void _resumeBuild(bool quiet = false);
+    void _watchPackages(const std::vector<std::string> &package_paths, bool quiet = false);
+    void _syncSources(const std::vector<std::string> &package_paths, bool quiet = false);
+    void _syncAllSources(bool quiet = false);
+    void _suggestPch(const std::string &package_path, size_t max_count = 20, bool write = false);
+    void _addComponent(const std::string &package_path, const std::string &component_name);
     void _cleanPackage(const std::string &package_path, bool quiet = false);
     void _cleanAllPackages(bool quiet = false);
     void _deletePackage(const std::string &package_path, bool quiet = false);
     void _deleteAllPackages(bool quiet = false);
     void _listPackages(bool basename_only = false, bool path_only = false);
+    void _showStats(const std::vector<std::string> &package_paths, const std::string &sort_key = "cpu", bool show_stages = false);
     void _resetInfo();
-    void _runPackage(const std::string &package_path, const std::string &program_name, const std::vector<std::string> &program_args);
+    void _runPackage(const std::string &package_path, const std::string &program_name, const std::vector<std::string> &program_args, const std::string &variant = "");
     void _attachPackage(const std::string &package_path, bool quiet = false);
     void _attachPackagesFromFile(const std::string &file_path, bool quiet = false);
     void _detachPackage(const std::string &package_path, bool quiet = false);
@@ -94,18 +182,88 @@ private:
     bool _createDirectory();
     void _createCPPProject();
     void _createCProject();
+    void _createLibraryProject();
+    void _createRtProject();
+    void _createModularProject();
+    void _createComponent(const std::string &component_name);
+    std::string _getTemplateDir();
+    void _createTemplateProject();
+    void _writeTemplateFiles(const std::vector<std::pair<std::string, std::string>> &files,
+                             const TemplateEngine::Variables &variables = TemplateEngine::Variables());
     void _createProject();
+    void _createProfileFile();
+    void _createBenchFiles();
+    void _createTraceFile();
+    TemplateEngine::Variables _getTemplateVariables();
     bool _deleteDirectory();
     bool _cleanInstallFiles();
     void _getAllPackagePaths(std::vector<std::string> &output_paths);
+    std::string _getBuildInputs();
+    std::string _getBuildJournalPath();
+    std::string _getBuildStatsPath();
+    std::string _getPgoCachePath(const std::string &package_path, const std::string &variant);
+    std::string _getPgoFingerprint(const std::string &package_path, const std::string &variant);
+    bool _restorePgoProfiles(const std::string &package_path, const std::string &variant);
+    bool _trainPgoProfiles(const std::string &package_path, const std::string &variant);
+    bool _syncPackageSources(const std::string &package_path, bool quiet);
+    std::string _getConfigureArgs(const std::string &package_path, const std::string &variant, std::string &environment);
+    std::string _getArtifactFingerprint(const std::string &package_path, const std::string &variant);
+    void _prefetchArtifacts(const std::vector<std::string> &package_paths, const std::vector<std::string> &variants);
+    void _findBuildPackages(const std::string &package_path, std::vector<std::string> &output_paths);
+    size_t _getCompileJobs();
+    const BuildVariant *_findBuildVariant(const std::string &variant) const;
+    std::string _getVariantBuildPath(const std::string &package_path, const std::string &variant);
+    std::string _getVariantPrefix(const std::string &package_path, const std::string &variant);
+    std::string _getProgramPath(const std::string &package_path, const std::string &program_name, const std::string &variant);
+    std::string _getJobTitle(const BuildJob &job);
+    std::string _getPackageGenerator(const std::string &package_path);
+    std::string _getDependencyPrefixes(const std::string &package_path, const std::string &variant);
+    BuildStageResult _runBuildStage(BuildJob &job, BuildStage stage, bool quiet, bool redirect_output);
+    void _printBuildSummary(const std::vector<BuildJob> &jobs, double total_seconds);
+    void _benchmarkBuilds(const std::vector<BuildJob> &jobs);
+    void _analyzeCompileTime(const std::vector<BuildJob> &jobs);
 
     std::string m_createInfoPath;
     std::string m_cppCMakePath;
     std::string m_cppMainPath;
+    std::string m_cppPchPath;
+    std::string m_cppModulesCMakePath;
+    std::string m_cppModulePath;
+    std::string m_cppModulesMainPath;
+    std::string m_cppModularCMakePath;
+    std::string m_cppModularMainPath;
+    std::string m_cppComponentCMakePath;
+    std::string m_cppComponentHeaderPath;
+    std::string m_cppComponentSourcePath;
+    std::string m_profilePath;
     std::string m_cCMakePath;
     std::string m_cMainPath;
+    std::string m_cppLibCMakePath;
+    std::string m_cppLibHeaderPath;
+    std::string m_cppLibSourcePath;
+    std::string m_cLibCMakePath;
+    std::string m_cLibHeaderPath;
+    std::string m_cLibSourcePath;
+    std::string m_rtCMakePath;
+    std::string m_rtSupportPath;
+    std::string m_rtMainPath;
+    std::string m_tracePath;
+    std::string m_benchCMakePath;
+    std::string m_benchHeaderPath;
+    std::string m_benchMainPath;
+    std::string m_templatesPath;    // named custom templates, 'create --template NAME'
+    TemplateEngine m_templateEngine;
 
     Package m_currentPackage;
+    // registered packages found by the find_package() calls of each package, see _getDependencyPrefixes
+    PackageGraph m_packageGraph;
 
     bool m_force{false};
+
+    CreateOptions m_createOptions;
+    BuildOptions m_buildOptions;
+    ArtifactCache m_artifactCache;
+    std::map<std::string, std::string> m_artifactFingerprints;    // "<package>\n<variant>" of the current build, see _getArtifactFingerprint
+    BuildJournal m_buildJournal;
+    BuildRoot m_buildRoot;
 };
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+
+// Watches the sources of packages with inotify: every directory below src/ and
+// include/ plus the CMake files in the package root. Events are coalesced until
+// nothing changed for the debounce interval, then the changed packages are
+// reported at once.
+class PackageWatcher
+{
+public:
+    explicit PackageWatcher(int debounce_ms = 300);
+    ~PackageWatcher();
+
+    bool addPackage(const std::string &package_path);
+    bool waitForChanges(std::set<std::string> &changed_packages);
+
+    size_t getWatchCount() const
+    {
+        return m_watches.size();
+    }
+
+private:
+    struct Watch
+    {
+        std::string package_path;
+        std::string dir_path;
+        bool package_root;
+    };
+
+    bool _addWatch(const std::string &package_path, const std::string &dir_path, bool package_root);
+    bool _addWatchRecursive(const std::string &package_path, const std::string &dir_path);
+    bool _readEvents(std::set<std::string> &changed_packages);
+
+    int m_fd{-1};
+    int m_debounceMs;
+    std::map<int, Watch> m_watches;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Proposes the headers of a package worth precompiling. The sources and headers
+// of src/ and include/ are scanned for #include directives by several threads;
+// a header is a good candidate when many files include it and it rarely changes:
+// system headers always qualify, package headers only when they were not
+// modified recently, since every change rebuilds the whole precompiled header.
+class PchAdvisor
+{
+public:
+    struct Candidate
+    {
+        std::string header;         // as written in the directive, e.g. "<vector>" or "\"config.hpp\""
+        size_t file_count{0};       // files including it
+        bool system{false};
+        bool recently_changed{false};
+    };
+
+    explicit PchAdvisor(size_t thread_count = 8);
+
+    void scan(const std::string &package_path);
+    // headers included by at least min_files files, most included first, recently changed ones excluded
+    std::vector<Candidate> suggest(size_t max_count, size_t min_files = 2) const;
+    std::vector<Candidate> getRecentlyChanged(size_t min_files = 2) const;
+
+    size_t getFileCount() const
+    {
+        return m_fileCount;
+    }
+
+    double getSeconds() const
+    {
+        return m_seconds;
+    }
+
+    static std::string getPchContents(const std::vector<Candidate> &candidates);
+
+private:
+    void _scanFile(const std::string &file_path);
+    bool _isRecentlyChanged(const std::string &file_path, const std::string &header_name) const;
+    std::vector<Candidate> _getCandidates(size_t min_files, bool recently_changed) const;
+
+    size_t m_threadCount;
+    std::string m_packagePath;
+    size_t m_fileCount{0};
+    double m_seconds{0.0};
+    std::map<std::string, Candidate> m_candidates;
+    mutable std::mutex m_mutex;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Warms the page cache with the sources, headers and CMake files of the packages
+// about to be built. It runs in the background while the first packages
+// configure, so compilers later find their inputs in memory instead of stalling
+// on a cold disk or NFS. Only files with pages missing from the cache are read.
+class SourcePrefetcher
+{
+public:
+    struct Stats
+    {
+        size_t files{0};
+        std::uint64_t bytes{0};
+        std::uint64_t cold_bytes{0};   // not in the page cache before the prefetch
+        double read_seconds{0.0};      // spent reading the cold pages, summed over all threads
+    };
+
+    explicit SourcePrefetcher(size_t thread_count = 8);
+    ~SourcePrefetcher();
+
+    SourcePrefetcher(const SourcePrefetcher &) = delete;
+    SourcePrefetcher &operator=(const SourcePrefetcher &) = delete;
+
+    void addPackage(const std::string &package_path);
+    void start();
+    void wait();
+
+    double getSeconds() const
+    {
+        return m_seconds;
+    }
+
+    Stats getStats(const std::string &package_path) const;
+    Stats getTotalStats() const;
+
+private:
+    void _run();
+    void _prefetchFile(size_t package_index, const std::string &file_path);
+
+    size_t m_threadCount;
+    std::vector<std::string> m_packagePaths;
+    std::vector<Stats> m_stats;
+    std::vector<std::pair<size_t, std::string>> m_files;
+    std::atomic<size_t> m_nextFile{0};
+    mutable std::mutex m_mutex;
+    std::thread m_thread;
+    double m_seconds{0.0};
+};
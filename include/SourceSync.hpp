@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Generates '<package>/sources.cmake' with explicit, sorted source lists, so the
+// package CMakeLists.txt needs no file(GLOB) and CMake reconfigures only when a
+// source is added or removed. The lists and their patterns are taken from the
+// fallback globs of CMakeLists.txt, e.g. file(GLOB TARGET_EXE_SRCS "src/*.cpp").
+// A modular package ('cmake_tool create --layout modular') also gets its
+// 'components.cmake' regenerated from the src/<component>/ folders, and every
+// component folder its own sources.cmake, as does the 'bench/' folder of
+// 'cmake_tool create --with-bench'.
+class SourceSync
+{
+public:
+    enum class Result
+    {
+        NOT_USED,   // CMakeLists.txt does not include sources.cmake
+        UNCHANGED,
+        UPDATED,
+        FAILED,
+    };
+
+    static Result sync(const std::string &package_path);
+    static std::string getSourcesPath(const std::string &package_path);
+    static std::string getComponentsPath(const std::string &package_path);
+    static std::vector<std::string> getComponents(const std::string &package_path);
+
+private:
+    struct SourceGlob
+    {
+        std::string variable;
+        std::string pattern;
+    };
+
+    static bool _readGlobs(const std::string &cmake_path, std::vector<SourceGlob> &globs);
+    static std::vector<std::string> _matchFiles(const std::string &package_path, const std::string &pattern);
+    static Result _syncSources(const std::string &dir_path, const SourceGlob &fallback_glob);
+    static Result _writeIfChanged(const std::string &path, const std::string &contents);
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Renders the '.in' templates of 'cmake_tool create'. A template is parsed once
+// into literal and %%VARIABLE%% tokens and kept, so creating many packages or a
+// template tree of many files reads and scans every template a single time.
+// Rendering sizes the output from the tokens first and then appends every token
+// once, instead of one search and replace pass over the text per variable.
+// Variables without a value stay in the output as written.
+class TemplateEngine
+{
+public:
+    typedef std::map<std::string, std::string> Variables;  // name without the %%, e.g. "PROJECT_NAME"
+
+    class Template
+    {
+    public:
+        void parse(std::string text);
+        void render(const Variables &variables, std::string &output) const;
+        std::string render(const Variables &variables) const;
+
+        bool empty() const
+        {
+            return m_text.empty();
+        }
+
+    private:
+        struct Token
+        {
+            size_t offset;
+            size_t length;      // the whole %%NAME%% for a variable
+            bool variable;
+        };
+
+        std::string m_text;
+        std::vector<Token> m_tokens;
+        size_t m_literalSize{0};
+    };
+
+    // the parsed template at template_path, nullptr when it can not be read or is empty
+    const Template *load(const std::string &template_path);
+
+    bool renderFile(const std::string &template_path, const std::string &output_path, const Variables &variables);
+
+    // Writes every file below template_dir to the same relative path below output_dir.
+    // Paths may contain variables, e.g. "src/%%PROJECT_NAME%%.cpp.in"; files ending
+    // in ".in" are rendered and lose the suffix, all others are copied unchanged.
+    // Returns the written paths, throws when a file can not be read or written.
+    std::vector<std::string> renderTree(const std::string &template_dir, const std::string &output_dir, const Variables &variables);
+
+private:
+    std::map<std::string, Template> m_templates;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "UtilityCommon.hpp"
+
+class HashUtils
+{
+public:
+    /**
+     * @brief The Sha256 class is an incremental SHA-256 hasher, so large
+     * files and streams can be digested without loading them into memory.
+     */
+    class Sha256
+    {
+    public:
+        Sha256();
+
+        /**
+         * @brief update Feeds more data into the hash
+         * @param data Pointer to the data
+         * @param size Number of bytes to hash
+         */
+        void update(const void *data, size_t size);
+
+        /**
+         * @brief update Feeds more data into the hash
+         * @param data The data to hash
+         */
+        void update(const std::string &data);
+
+        /**
+         * @brief hexDigest Finishes the hash
+         * @return Return the lower-case hexadecimal digest (64 characters)
+         */
+        std::string hexDigest();
+
+    private:
+        void _transform(const std::uint8_t *block);
+
+        std::uint32_t m_state[8];
+        std::uint8_t m_buffer[64];
+        std::uint64_t m_length{0};
+        size_t m_buffer_size{0};
+    };
+
+    /**
+     * @brief sha256 Computes the SHA-256 digest of a string
+     * @param data The data to hash
+     * @return Return the lower-case hexadecimal digest
+     */
+    static std::string sha256(const std::string &data);
+
+    /**
+     * @brief sha256File Computes the SHA-256 digest of a file
+     * @param input_path_string Full path to the file
+     * @return Return the lower-case hexadecimal digest, or empty string if
+     * the file could not be read
+     */
+    static std::string sha256File(const std::string &input_path_string);
+
+    /**
+     * @brief isHexDigest Checks that a string looks like a SHA-256 hex digest
+     * @param input_string The string to check
+     * @return Return true if input_string is 64 lower-case hexadecimal characters
+     */
+    static bool isHexDigest(const std::string &input_string);
+};
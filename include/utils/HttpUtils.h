@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "UtilityCommon.hpp"
+
+/**
+ * @brief The HttpUtils class provides a minimal blocking HTTP/1.1 client and
+ * the socket helpers shared with the cache server. Only plain http:// URLs,
+ * Content-Length bodies and "Connection: close" requests are supported.
+ */
+class HttpUtils
+{
+public:
+    struct Url
+    {
+        std::string host;
+        std::string port{"80"};
+        std::string path{"/"};
+    };
+
+    /**
+     * @brief parseUrl Splits an http:// URL into host, port and path
+     * @param url The URL to parse
+     * @param[out] output_url The parsed URL
+     * @return Return true if url is a valid http:// URL
+     */
+    static bool parseUrl(const std::string &url, Url &output_url);
+
+    /**
+     * @brief get Sends a GET request and keeps the response body in memory
+     * @param url The URL to request
+     * @param[out] output_body The response body
+     * @return Return the HTTP status code, or -1 on connection error
+     */
+    static int get(const std::string &url, std::string &output_body);
+
+    /**
+     * @brief getToFile Sends a GET request and streams the response body to a file
+     * @param url The URL to request
+     * @param output_path The file to write; only complete bodies are kept
+     * @return Return the HTTP status code, or -1 on connection error
+     */
+    static int getToFile(const std::string &url, const std::string &output_path);
+
+    /**
+     * @brief head Sends a HEAD request
+     * @param url The URL to request
+     * @return Return the HTTP status code, or -1 on connection error
+     */
+    static int head(const std::string &url);
+
+    /**
+     * @brief put Sends a PUT request with an in-memory body
+     * @param url The URL to request
+     * @param body The request body
+     * @return Return the HTTP status code, or -1 on connection error
+     */
+    static int put(const std::string &url, const std::string &body);
+
+    /**
+     * @brief putFile Sends a PUT request streaming the body from a file
+     * @param url The URL to request
+     * @param input_path The file to upload
+     * @return Return the HTTP status code, or -1 on connection/read error
+     */
+    static int putFile(const std::string &url, const std::string &input_path);
+
+    /**
+     * @brief connectTo Opens a TCP connection
+     * @param host Host name or address
+     * @param port Port number or service name
+     * @return Return the socket descriptor, or -1 on failure
+     */
+    static int connectTo(const std::string &host, const std::string &port);
+
+    /**
+     * @brief listenOn Opens a listening TCP socket
+     * @param bind_address Address to bind, eg. 127.0.0.1 or 0.0.0.0
+     * @param port Port to bind
+     * @return Return the socket descriptor, or -1 on failure
+     */
+    static int listenOn(const std::string &bind_address, int port);
+
+    /**
+     * @brief sendAll Writes the whole buffer to a socket
+     * @return Return true if every byte was sent
+     */
+    static bool sendAll(int fd, const char *data, size_t size);
+
+    /**
+     * @brief readHeaders Reads from a socket up to the end of the HTTP header block
+     * @param fd The socket to read
+     * @param[out] output_headers The header block without the trailing blank line
+     * @param[out] output_body_prefix Body bytes that were read past the headers
+     * @return Return true if a complete header block was read
+     */
+    static bool readHeaders(int fd, std::string &output_headers, std::string &output_body_prefix);
+
+    /**
+     * @brief headerValue Looks up a header in a header block (case-insensitive)
+     * @return Return the trimmed header value, or empty string if not found
+     */
+    static std::string headerValue(const std::string &headers, const std::string &name);
+
+    /**
+     * @brief setTimeout Sets send and receive timeouts on a socket
+     */
+    static void setTimeout(int fd, int seconds);
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "UtilityCommon.hpp"
+
+/**
+ * @brief The JsonStreamParser class is a pull parser reading JSON from a file
+ * in fixed size chunks. It returns one token at a time and never builds a
+ * document tree, so memory use does not depend on the size of the input.
+ */
+class JsonStreamParser
+{
+public:
+    enum class Token
+    {
+        OBJECT_BEGIN,
+        OBJECT_END,
+        ARRAY_BEGIN,
+        ARRAY_END,
+        KEY,
+        STRING,
+        NUMBER,
+        BOOLEAN,
+        NULL_VALUE,
+        END,
+        ERROR,
+    };
+
+    JsonStreamParser();
+    ~JsonStreamParser();
+
+    JsonStreamParser(const JsonStreamParser &) = delete;
+    JsonStreamParser &operator=(const JsonStreamParser &) = delete;
+
+    /**
+     * @brief open Opens a JSON file for parsing
+     * @param input_path_string Path of the file
+     * @return Returns true if the file could be opened
+     */
+    bool open(const std::string &input_path_string);
+
+    /**
+     * @brief next Reads the next token
+     * @return Returns the token, END after the last top level value and
+     * ERROR on malformed input
+     */
+    Token next();
+
+    /**
+     * @brief value Text of the last KEY, STRING, NUMBER or BOOLEAN token,
+     * strings are unescaped
+     * @return Returns the text of the last token
+     */
+    const std::string &value() const
+    {
+        return m_value;
+    }
+
+    /**
+     * @brief depth Number of objects and arrays enclosing the parse position
+     * @return Returns the nesting depth
+     */
+    size_t depth() const
+    {
+        return m_stack.size();
+    }
+
+    /**
+     * @brief skipValue Skips the next value including everything nested in
+     * it, typically called after a KEY token that is not of interest
+     * @return Returns false on malformed input
+     */
+    bool skipValue();
+
+private:
+    int _peek();
+    int _get();
+    void _skipWhitespace();
+    bool _readString(std::string &output_string);
+    void _endValue();
+
+    FILE *m_file{nullptr};
+    char m_buffer[64 * 1024];
+    size_t m_pos{0};
+    size_t m_size{0};
+
+    std::string m_value;
+    std::vector<char> m_stack;
+    bool m_expectKey{false};
+};
@@ -3,6 +3,7 @@
 #include "UtilityCommon.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <locale>
 #include <codecvt>
 #include <string>
@@ -25,6 +26,32 @@
 #endif
 
 
+/**
+ * @brief The ProcessUsage struct holds the resources used by a child process
+ * and all of its descendants it waited for
+ */
+struct ProcessUsage
+{
+    double user_seconds{0.0};
+    double system_seconds{0.0};
+    std::uint64_t max_rss_kb{0};       // peak resident set of the largest single process
+    std::uint64_t block_input{0};      // file system reads, in 512 byte blocks
+    std::uint64_t block_output{0};     // file system writes, in 512 byte blocks
+
+    /**
+     * @brief add Accumulates the usage of another process run after this one
+     * @param other Usage to add, times and blocks are summed, the peak RSS is the maximum
+     */
+    void add(const ProcessUsage &other)
+    {
+        user_seconds += other.user_seconds;
+        system_seconds += other.system_seconds;
+        max_rss_kb = other.max_rss_kb > max_rss_kb ? other.max_rss_kb : max_rss_kb;
+        block_input += other.block_input;
+        block_output += other.block_output;
+    }
+};
+
 class SystemUtils
 {
 public:
@@ -77,6 +104,28 @@ public:
      */
     static int execute(const std::string &command);
 
+    /**
+     * @brief executeShell Runs a command through /bin/sh and waits for it.
+     * Unlike system() this is safe to call from several threads at once.
+     * @param command The shell command line
+     * @param output_path Optional file receiving stdout and stderr of the
+     * command (appended), otherwise the output goes to the terminal
+     * @param usage Optional, receives the resources used by the command and
+     * everything it ran (added to the current values)
+     * @return Returns the exit status of the command, or -1 if it could not
+     * be started or was killed by a signal
+     */
+    static int executeShell(const std::string &command, const std::string &output_path = "", ProcessUsage *usage = nullptr);
+
+    /**
+     * @brief findExecutable Searches the directories of PATH for a program
+     * @param program_name Name of the program, a name containing '/' is
+     * only checked for being executable
+     * @return Returns the full path of the program, or an empty string if it
+     * is not found
+     */
+    static std::string findExecutable(const std::string &program_name);
+
     /**
      * @brief getCurrentDirectory Gets the current directory
      * @return Returns string representing the current directory
@@ -0,0 +1,60 @@
+#!/bin/sh
+# Compiler launcher of 'cmake_tool build --analyze-compile-time' for GCC.
+# Compiles with -ftime-report and writes '<object>.json' in the -ftime-trace
+# format of Clang: the whole compile, frontend, backend and template time.
+
+object=""
+source=""
+previous=""
+for arg in "$@"; do
+    if [ "$previous" = "-o" ]; then
+        object="$arg"
+    fi
+    case "$arg" in
+        *.c|*.cc|*.cp|*.cpp|*.cxx|*.c++|*.C) source="$arg" ;;
+    esac
+    previous="$arg"
+done
+
+if [ -z "$object" ] || [ -z "$source" ]; then
+    exec "$@"
+fi
+
+report="$object.time_report"
+start=$(date +%s%N)
+"$@" -ftime-report 2> "$report"
+status=$?
+end=$(date +%s%N)
+
+# hand the diagnostics back, drop the report
+awk '/^Time variable/ { exit } { print }' "$report" >&2
+
+# wall time of a report row in microseconds
+phase()
+{
+    awk -F: -v name="$1" '{
+        key = $1; gsub(/^ +| +$/, "", key)
+        if (key == name) { rest = $2; gsub(/\([^)]*\)/, "", rest); split(rest, t, " "); printf "%d", t[3] * 1000000; exit }
+    }' "$report"
+}
+
+if [ $status -eq 0 ]; then
+    parsing=$(phase "phase parsing")
+    deferred=$(phase "phase lang. deferred")
+    backend=$(phase "phase opt and generate")
+    templates=$(phase "template instantiation")
+    frontend=$(( ${parsing:-0} + ${deferred:-0} ))
+    total=$(( (end - start) / 1000 ))
+    detail=$(printf '%s' "$source" | sed 's/\\/\\\\/g; s/"/\\"/g')
+    # GCC reports class and function instantiation together
+    cat > "${object%.o}.json" <<TRACE
+{"traceEvents":[
+{"ph":"X","name":"ExecuteCompiler","ts":0,"dur":$total,"args":{"detail":"$detail"}},
+{"ph":"X","name":"Frontend","ts":0,"dur":$frontend},
+{"ph":"X","name":"Backend","ts":$frontend,"dur":${backend:-0}},
+{"ph":"X","name":"Total InstantiateFunction","ts":0,"dur":${templates:-0}}
+]}
+TRACE
+fi
+rm -f "$report"
+exit $status
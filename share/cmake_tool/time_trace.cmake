@@ -0,0 +1,10 @@
+# Included after project() by 'cmake_tool build --analyze-compile-time'.
+# Clang writes a -ftime-trace JSON next to every object file, GCC is run through
+# a launcher writing the same trace format from -ftime-report.
+foreach(lang C CXX)
+    if(CMAKE_${lang}_COMPILER_ID MATCHES "Clang")
+        add_compile_options($<$<COMPILE_LANGUAGE:${lang}>:-ftime-trace>)
+    elseif(CMAKE_${lang}_COMPILER_ID STREQUAL "GNU")
+        set(CMAKE_${lang}_COMPILER_LAUNCHER sh "${CMAKE_CURRENT_LIST_DIR}/time_compile.sh")
+    endif()
+endforeach()
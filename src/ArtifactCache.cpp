@@ -0,0 +1,433 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "ArtifactCache.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/HashUtils.h"
+#include "utils/HttpUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/SystemUtils.h"
+
+// top level entries of a package that hold build or install outputs, never inputs
+static const char *s_output_entries[] = {"build", "bin", "lib", "install", ".git"};
+
+static bool _isOutputEntry(const std::string &name)
+{
+    for (const char *entry : s_output_entries)
+    {
+        if (name == entry)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _collectInputFiles(const std::string &root_path, const std::string &relative_dir, std::vector<std::string> &output_files)
+{
+    std::string dir_path = relative_dir.empty() ? root_path : FileUtils::buildFilePath(root_path, relative_dir);
+    DIR *dir = opendir(dir_path.c_str());
+    if (NULL == dir)
+    {
+        return;
+    }
+
+    struct dirent *dp;
+    while ((dp = readdir(dir)) != NULL)
+    {
+        std::string name(dp->d_name);
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+        if (relative_dir.empty() && _isOutputEntry(name))
+        {
+            continue;
+        }
+
+        std::string relative_path = relative_dir.empty() ? name : relative_dir + "/" + name;
+        struct stat st;
+        if (lstat(FileUtils::buildFilePath(root_path, relative_path).c_str(), &st) != 0)
+        {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            _collectInputFiles(root_path, relative_path, output_files);
+        }
+        else if (S_ISREG(st.st_mode))
+        {
+            output_files.emplace_back(relative_path);
+        }
+    }
+    closedir(dir);
+}
+
+ArtifactCache::ArtifactCache()
+: m_cacheDir(getDefaultCacheDirectory())
+{
+}
+
+ArtifactCache::~ArtifactCache()
+{
+    flush();
+}
+
+std::string ArtifactCache::getDefaultCacheDirectory()
+{
+    std::string cache_dir = SystemUtils::getEnv("CMAKE_TOOL_CACHE_DIR");
+    if (!cache_dir.empty())
+    {
+        return cache_dir;
+    }
+
+    std::string xdg_cache_home = SystemUtils::getEnv("XDG_CACHE_HOME");
+    if (xdg_cache_home.empty())
+    {
+        xdg_cache_home = FileUtils::buildFilePath(SystemUtils::getUserHomeDirectory(), ".cache");
+    }
+    return FileUtils::buildFilePath(xdg_cache_home, "cmake_tool/artifacts");
+}
+
+void ArtifactCache::setCacheDirectory(const std::string &cache_dir)
+{
+    m_cacheDir = cache_dir;
+}
+
+void ArtifactCache::setRemoteUrl(const std::string &remote_url)
+{
+    m_remoteUrl = remote_url;
+    while (!m_remoteUrl.empty() && m_remoteUrl.back() == '/')
+    {
+        m_remoteUrl.pop_back();
+    }
+}
+
+void ArtifactCache::setRemoteJobs(size_t remote_jobs)
+{
+    m_remoteJobs = remote_jobs > 0 ? remote_jobs : 1;
+}
+
+std::string ArtifactCache::_acPath(const std::string &fingerprint) const
+{
+    return FileUtils::buildFilePath(m_cacheDir, "ac/" + fingerprint);
+}
+
+std::string ArtifactCache::_casPath(const std::string &digest) const
+{
+    return FileUtils::buildFilePath(m_cacheDir, "cas/" + digest);
+}
+
+void ArtifactCache::_warning(const std::string &message)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::cerr << "Warning: " << message << std::endl;
+}
+
+std::string ArtifactCache::computeFingerprint(const std::string &package_path, const std::string &build_inputs) const
+{
+    std::vector<std::string> input_files;
+    _collectInputFiles(package_path, "", input_files);
+    std::sort(input_files.begin(), input_files.end());
+
+    HashUtils::Sha256 hasher;
+    hasher.update(build_inputs);
+    hasher.update("\n", 1);
+    for (const std::string &relative_path : input_files)
+    {
+        std::string file_digest = HashUtils::sha256File(FileUtils::buildFilePath(package_path, relative_path));
+        hasher.update(relative_path);
+        hasher.update("\0", 1);
+        hasher.update(file_digest);
+        hasher.update("\n", 1);
+    }
+    return hasher.hexDigest();
+}
+
+bool ArtifactCache::_readEntry(const std::string &fingerprint, std::string &digest, std::vector<std::string> &files) const
+{
+    std::vector<std::string> lines;
+    if (!FileUtils::getFileLines(_acPath(fingerprint), lines) || lines.empty())
+    {
+        return false;
+    }
+
+    digest = StringUtils::trimmed(lines[0]);
+    if (!HashUtils::isHexDigest(digest))
+    {
+        return false;
+    }
+
+    files.clear();
+    for (size_t i = 1; i < lines.size(); ++i)
+    {
+        if (!StringUtils::trimmed(lines[i]).empty())
+        {
+            files.emplace_back(lines[i]);
+        }
+    }
+    return true;
+}
+
+bool ArtifactCache::restore(const std::string &fingerprint, const std::string &package_path, const std::string &build_path)
+{
+    std::string digest;
+    std::vector<std::string> files;
+    bool found = _readEntry(fingerprint, digest, files) && FileUtils::fileExists(_casPath(digest));
+    if (!found && !m_remoteUrl.empty())
+    {
+        found = _fetchRemote(fingerprint) && _readEntry(fingerprint, digest, files);
+    }
+    if (!found)
+    {
+        return false;
+    }
+
+    std::string cmd = "tar -xzf \"" + _casPath(digest) + "\" -C \"" + package_path + "\"";
+    pid_t status = system(cmd.c_str());
+    if (0 != WEXITSTATUS(status))
+    {
+        _warning("failed to extract cached artifact " + digest);
+        return false;
+    }
+
+    // keep 'cmake_tool clean' working for restored packages
+    FileUtils::createDirectory(build_path);
+    std::string manifest;
+    for (const std::string &relative_path : files)
+    {
+        manifest += FileUtils::buildFilePath(package_path, relative_path) + "\n";
+    }
+    FileUtils::writeFileContents(FileUtils::buildFilePath(build_path, "install_manifest.txt"), manifest);
+    return true;
+}
+
+bool ArtifactCache::store(const std::string &fingerprint, const std::string &package_path, const std::string &manifest_path)
+{
+    std::vector<std::string> installed_files;
+    if (!FileUtils::getFileLines(manifest_path, installed_files))
+    {
+        return false;
+    }
+
+    std::string prefix = package_path;
+    if (prefix.back() != '/')
+    {
+        prefix += "/";
+    }
+
+    std::vector<std::string> relative_files;
+    for (const std::string &installed_file : installed_files)
+    {
+        if (StringUtils::trimmed(installed_file).empty())
+        {
+            continue;
+        }
+        if (!StringUtils::startsWith(installed_file, prefix))
+        {
+            _warning("\"" + installed_file + "\" is installed outside of the package, artifact not cached");
+            return false;
+        }
+        relative_files.emplace_back(installed_file.substr(prefix.size()));
+    }
+    if (relative_files.empty())
+    {
+        return false;
+    }
+
+    FileUtils::createDirectory(FileUtils::buildFilePath(m_cacheDir, "ac"));
+    FileUtils::createDirectory(FileUtils::buildFilePath(m_cacheDir, "cas"));
+
+    std::string temp_id = StringUtils::createUUID();
+    std::string list_path = FileUtils::buildFilePath(m_cacheDir, "cas/" + temp_id + ".list");
+    std::string temp_path = FileUtils::buildFilePath(m_cacheDir, "cas/" + temp_id + ".tmp");
+    FileUtils::writeFileContents(list_path, StringUtils::join(relative_files, "\n") + "\n");
+
+    // gzip compresses the tar stream as it is produced, the blob never sits uncompressed on disk
+    std::string cmd = "tar -czf \"" + temp_path + "\" -C \"" + package_path + "\" -T \"" + list_path + "\"";
+    pid_t status = system(cmd.c_str());
+    FileUtils::deleteFile(list_path);
+    if (0 != WEXITSTATUS(status))
+    {
+        FileUtils::deleteFile(temp_path);
+        return false;
+    }
+
+    std::string digest = HashUtils::sha256File(temp_path);
+    FileUtils::renameFile(temp_path, _casPath(digest));
+
+    std::string entry_temp_path = _acPath(fingerprint) + "." + temp_id + ".tmp";
+    FileUtils::writeFileContents(entry_temp_path, digest + "\n" + StringUtils::join(relative_files, "\n") + "\n");
+    FileUtils::renameFile(entry_temp_path, _acPath(fingerprint));
+
+    if (!m_remoteUrl.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_uploadQueue.emplace_back(fingerprint);
+        if (m_uploaders.size() < m_remoteJobs)
+        {
+            m_uploaders.emplace_back(&ArtifactCache::_uploadWorker, this);
+        }
+        m_uploadCondition.notify_one();
+    }
+    return true;
+}
+
+bool ArtifactCache::_fetchRemote(const std::string &fingerprint)
+{
+    std::string entry;
+    int status = HttpUtils::get(m_remoteUrl + "/ac/" + fingerprint, entry);
+    if (status == 404)
+    {
+        return false;
+    }
+    if (status != 200)
+    {
+        _warning("remote cache \"" + m_remoteUrl + "\" unavailable (GET ac status " + std::to_string(status) + ")");
+        return false;
+    }
+
+    std::string digest = StringUtils::trimmed(entry.substr(0, entry.find('\n')));
+    if (!HashUtils::isHexDigest(digest))
+    {
+        _warning("remote cache returned a malformed entry for " + fingerprint);
+        return false;
+    }
+
+    FileUtils::createDirectory(FileUtils::buildFilePath(m_cacheDir, "ac"));
+    FileUtils::createDirectory(FileUtils::buildFilePath(m_cacheDir, "cas"));
+
+    std::string temp_id = StringUtils::createUUID();
+    if (!FileUtils::fileExists(_casPath(digest)))
+    {
+        std::string temp_path = _casPath(digest) + "." + temp_id + ".tmp";
+        status = HttpUtils::getToFile(m_remoteUrl + "/cas/" + digest, temp_path);
+        if (status != 200)
+        {
+            _warning("remote cache is missing artifact " + digest + " (GET cas status " + std::to_string(status) + ")");
+            return false;
+        }
+        if (HashUtils::sha256File(temp_path) != digest)
+        {
+            FileUtils::deleteFile(temp_path);
+            _warning("remote artifact " + digest + " is corrupted, ignored");
+            return false;
+        }
+        FileUtils::renameFile(temp_path, _casPath(digest));
+    }
+
+    std::string entry_temp_path = _acPath(fingerprint) + "." + temp_id + ".tmp";
+    FileUtils::writeFileContents(entry_temp_path, entry);
+    FileUtils::renameFile(entry_temp_path, _acPath(fingerprint));
+    return true;
+}
+
+bool ArtifactCache::_uploadRemote(const std::string &fingerprint)
+{
+    std::string digest;
+    std::vector<std::string> files;
+    if (!_readEntry(fingerprint, digest, files))
+    {
+        return false;
+    }
+
+    // content addressed blobs are immutable, skip the upload if the server has it
+    std::string cas_url = m_remoteUrl + "/cas/" + digest;
+    if (HttpUtils::head(cas_url) != 200 && HttpUtils::putFile(cas_url, _casPath(digest)) != 200)
+    {
+        return false;
+    }
+    return HttpUtils::put(m_remoteUrl + "/ac/" + fingerprint, FileUtils::getFileContents(_acPath(fingerprint))) == 200;
+}
+
+void ArtifactCache::_uploadWorker()
+{
+    while (true)
+    {
+        std::string fingerprint;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_uploadCondition.wait(lock, [this]() { return m_uploadDone || !m_uploadQueue.empty(); });
+            if (m_uploadQueue.empty())
+            {
+                return;
+            }
+            fingerprint = m_uploadQueue.front();
+            m_uploadQueue.pop_front();
+        }
+
+        bool uploaded = _uploadRemote(fingerprint);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_uploadCount;
+        if (!uploaded)
+        {
+            ++m_uploadFailures;
+            std::cerr << "Warning: failed to upload artifact " << fingerprint << " to \"" << m_remoteUrl << "\"" << std::endl;
+        }
+    }
+}
+
+void ArtifactCache::prefetch(const std::vector<std::string> &fingerprints)
+{
+    if (m_remoteUrl.empty() || fingerprints.empty())
+    {
+        return;
+    }
+
+    std::vector<std::string> missing;
+    for (const std::string &fingerprint : fingerprints)
+    {
+        if (!FileUtils::fileExists(_acPath(fingerprint)))
+        {
+            missing.emplace_back(fingerprint);
+        }
+    }
+
+    std::atomic<size_t> next_index(0);
+    std::vector<std::thread> workers;
+    size_t worker_count = std::min(m_remoteJobs, missing.size());
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        workers.emplace_back([this, &missing, &next_index]() {
+            size_t index;
+            while ((index = next_index++) < missing.size())
+            {
+                _fetchRemote(missing[index]);
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ArtifactCache::flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_uploaders.empty())
+        {
+            return;
+        }
+        m_uploadDone = true;
+    }
+    m_uploadCondition.notify_all();
+    for (std::thread &uploader : m_uploaders)
+    {
+        uploader.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::cout << "<< uploaded " << (m_uploadCount - m_uploadFailures) << "/" << m_uploadCount << " artifacts to \"" << m_remoteUrl << "\"" << std::endl;
+    m_uploaders.clear();
+    m_uploadDone = false;
+    m_uploadCount = 0;
+    m_uploadFailures = 0;
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+#include "BenchmarkReport.hpp"
+
+#include "utils/SystemUtils.h"
+
+// two sided 97.5% quantiles of Student's t distribution for 1..30 degrees of freedom
+static const double s_t_quantiles[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+static std::string _formatSize(std::uint64_t size)
+{
+    char buffer[32];
+    if (size >= (1u << 20))
+    {
+        snprintf(buffer, sizeof(buffer), "%.1f MiB", size / 1048576.0);
+    }
+    else
+    {
+        snprintf(buffer, sizeof(buffer), "%.1f KiB", size / 1024.0);
+    }
+    return buffer;
+}
+
+void BenchmarkReport::addEntry(const BenchmarkEntry &entry)
+{
+    m_entries.emplace_back(entry);
+}
+
+void BenchmarkReport::summarize(const std::vector<double> &samples, double &mean, double &half_width)
+{
+    mean = 0.0;
+    half_width = 0.0;
+    if (samples.empty())
+    {
+        return;
+    }
+    for (double sample : samples)
+    {
+        mean += sample;
+    }
+    mean /= samples.size();
+    if (samples.size() < 2)
+    {
+        return;
+    }
+
+    double variance = 0.0;
+    for (double sample : samples)
+    {
+        variance += (sample - mean) * (sample - mean);
+    }
+    variance /= samples.size() - 1;
+
+    size_t degrees = samples.size() - 1;
+    double t = degrees <= 30 ? s_t_quantiles[degrees - 1] : 1.960;
+    half_width = t * std::sqrt(variance / samples.size());
+}
+
+void BenchmarkReport::run(const std::string &program_args, size_t runs)
+{
+    m_runs = runs;
+    for (BenchmarkEntry &entry : m_entries)
+    {
+        // warm up page cache and dynamic loader once, this run is not measured
+        std::string cmd = "exec \"" + entry.program_path + "\" " + program_args;
+        entry.failed = entry.failed || 0 != SystemUtils::executeShell(cmd, "/dev/null");
+    }
+
+    // round robin over the variants, so drifting machine load hits all of them alike
+    for (size_t run = 0; run < runs; ++run)
+    {
+        for (BenchmarkEntry &entry : m_entries)
+        {
+            if (entry.failed)
+            {
+                continue;
+            }
+            std::string cmd = "exec \"" + entry.program_path + "\" " + program_args;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            int status = SystemUtils::executeShell(cmd, "/dev/null");
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (status != 0)
+            {
+                entry.failed = true;
+                continue;
+            }
+            entry.run_seconds.emplace_back(elapsed.count());
+        }
+        std::cout << "\rBenchmark run " << run + 1 << "/" << runs << std::flush;
+    }
+    std::cout << std::endl;
+}
+
+void BenchmarkReport::print() const
+{
+    int max_first_column_width = 8;
+    double best_mean = 0.0;
+    for (const BenchmarkEntry &entry : m_entries)
+    {
+        max_first_column_width = std::max<int>(max_first_column_width, entry.name.length() + 1);
+        double mean = 0.0, half_width = 0.0;
+        summarize(entry.run_seconds, mean, half_width);
+        if (!entry.failed && mean > 0.0 && (best_mean == 0.0 || mean < best_mean))
+        {
+            best_mean = mean;
+        }
+    }
+
+    std::cout << std::endl
+              << "Benchmark (" << m_runs << " runs, mean with 95% confidence interval):" << std::endl;
+    printf("    %-*s %10s %12s %24s %8s\n", max_first_column_width, "build", "compile", "binary", "runtime", "ratio");
+    for (const BenchmarkEntry &entry : m_entries)
+    {
+        if (entry.failed)
+        {
+            printf("    %-*s %9.1fs %12s %24s %8s\n", max_first_column_width, entry.name.c_str(), entry.compile_seconds,
+                   _formatSize(entry.binary_size).c_str(), "failed", "-");
+            continue;
+        }
+        double mean = 0.0, half_width = 0.0;
+        summarize(entry.run_seconds, mean, half_width);
+        char runtime[64];
+        snprintf(runtime, sizeof(runtime), "%.3f ms +- %.3f", mean * 1e3, half_width * 1e3);
+        printf("    %-*s %9.1fs %12s %24s %7.2fx\n", max_first_column_width, entry.name.c_str(), entry.compile_seconds,
+               _formatSize(entry.binary_size).c_str(), runtime, best_mean > 0.0 ? mean / best_mean : 0.0);
+    }
+}
@@ -0,0 +1,129 @@
+#include <cstdio>
+
+#include "BuildJournal.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/StringUtils.h"
+
+static const char *s_journal_header = "# cmake_tool build journal";
+
+void BuildJournal::create(const std::string &journal_path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_journalPath = journal_path;
+    m_entries.clear();
+    _save();
+}
+
+bool BuildJournal::load(const std::string &journal_path)
+{
+    std::vector<std::string> lines;
+    if (!FileUtils::fileExists(journal_path) || !FileUtils::getFileLines(journal_path, lines) ||
+        lines.empty() || lines.front() != s_journal_header)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_journalPath = journal_path;
+    m_entries.clear();
+    for (size_t i = 1; i < lines.size(); ++i)
+    {
+        size_t tab = lines[i].find('\t');
+        if (tab == std::string::npos)
+        {
+            continue;
+        }
+        Entry entry;
+        entry.package_path = lines[i].substr(tab + 1);
+        entry.state = BuildJobState::PENDING;
+        std::string state_name = lines[i].substr(0, tab);
+        for (BuildJobState state : {BuildJobState::SUCCEEDED, BuildJobState::CACHED, BuildJobState::FAILED, BuildJobState::SKIPPED})
+        {
+            if (state_name == BuildScheduler::getStateName(state))
+            {
+                entry.state = state;
+            }
+        }
+        m_entries.emplace_back(entry);
+    }
+    return true;
+}
+
+void BuildJournal::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_journalPath.clear();
+    m_entries.clear();
+}
+
+void BuildJournal::addPackages(const std::vector<std::string> &package_paths)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const std::string &package_path : package_paths)
+    {
+        bool found = false;
+        for (Entry &entry : m_entries)
+        {
+            if (entry.package_path == package_path)
+            {
+                entry.state = BuildJobState::PENDING;
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+        {
+            m_entries.push_back({package_path, BuildJobState::PENDING});
+        }
+    }
+    _save();
+}
+
+void BuildJournal::setState(const std::string &package_path, BuildJobState state)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Entry &entry : m_entries)
+    {
+        if (entry.package_path == package_path)
+        {
+            entry.state = state;
+            _save();
+            return;
+        }
+    }
+}
+
+std::vector<std::string> BuildJournal::getUnfinishedPackages() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> package_paths;
+    for (const Entry &entry : m_entries)
+    {
+        if (entry.state != BuildJobState::SUCCEEDED && entry.state != BuildJobState::CACHED)
+        {
+            package_paths.emplace_back(entry.package_path);
+        }
+    }
+    return package_paths;
+}
+
+void BuildJournal::_save() const
+{
+    if (m_journalPath.empty())
+    {
+        return;
+    }
+
+    std::string contents = std::string(s_journal_header) + "\n";
+    for (const Entry &entry : m_entries)
+    {
+        contents += std::string(BuildScheduler::getStateName(entry.state)) + "\t" + entry.package_path + "\n";
+    }
+
+    std::string temp_path = m_journalPath + ".tmp";
+    if (FileUtils::writeFileContents(temp_path, contents))
+    {
+        std::rename(temp_path.c_str(), m_journalPath.c_str());
+    }
+}
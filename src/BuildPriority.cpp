@@ -0,0 +1,144 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "BuildPriority.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/StringUtils.h"
+
+// linux/ioprio.h is not shipped by every libc
+static const int s_ioprio_class_shift = 13;
+static const int s_ioprio_class_best_effort = 2;
+static const int s_ioprio_class_idle = 3;
+static const int s_ioprio_who_process = 1;
+
+static bool _setIoPriority(int io_class, int level)
+{
+#ifdef SYS_ioprio_set
+    return 0 == syscall(SYS_ioprio_set, s_ioprio_who_process, 0, (io_class << s_ioprio_class_shift) | level);
+#else
+    (void)io_class;
+    (void)level;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+bool BuildPriority::parse(const std::string &name, BuildPriorityClass &priority)
+{
+    for (BuildPriorityClass candidate : {BuildPriorityClass::BACKGROUND, BuildPriorityClass::NORMAL, BuildPriorityClass::HIGH})
+    {
+        if (StringUtils::equals(name, getName(candidate)))
+        {
+            priority = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *BuildPriority::getName(BuildPriorityClass priority)
+{
+    switch (priority)
+    {
+    case BuildPriorityClass::BACKGROUND:
+        return "background";
+    case BuildPriorityClass::NORMAL:
+        return "normal";
+    case BuildPriorityClass::HIGH:
+        return "high";
+    }
+    return "unknown";
+}
+
+bool BuildPriority::parseCpuList(const std::string &cpu_list, std::vector<int> &cpus)
+{
+    // "0-3,6" as in taskset -c and /sys/devices/system/cpu/online
+    cpus.clear();
+    for (const std::string &item : StringUtils::split(cpu_list, ","))
+    {
+        std::string range = StringUtils::trimmed(item);
+        if (range.empty())
+        {
+            continue;
+        }
+        char *end = nullptr;
+        long first = strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-')
+        {
+            last = strtol(end + 1, &end, 10);
+        }
+        if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE)
+        {
+            return false;
+        }
+        for (long cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.emplace_back(static_cast<int>(cpu));
+        }
+    }
+    return !cpus.empty();
+}
+
+bool BuildPriority::apply(BuildPriorityClass priority, const std::vector<int> &cpus)
+{
+    bool success = true;
+    if (priority == BuildPriorityClass::BACKGROUND)
+    {
+        if (0 != setpriority(PRIO_PROCESS, 0, 19) || !_setIoPriority(s_ioprio_class_idle, 0))
+        {
+            std::cerr << "Warning: could not lower the build priority: " << strerror(errno) << std::endl;
+            success = false;
+        }
+    }
+    else if (priority == BuildPriorityClass::HIGH)
+    {
+        if (0 != setpriority(PRIO_PROCESS, 0, -5) || !_setIoPriority(s_ioprio_class_best_effort, 0))
+        {
+            std::cerr << "Warning: could not raise the build priority (needs CAP_SYS_NICE): " << strerror(errno) << std::endl;
+            success = false;
+        }
+    }
+
+    if (!cpus.empty())
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int cpu : cpus)
+        {
+            CPU_SET(cpu, &cpu_set);
+        }
+        if (0 != sched_setaffinity(0, sizeof(cpu_set), &cpu_set))
+        {
+            std::cerr << "Warning: could not restrict the build to the given cpus: " << strerror(errno) << std::endl;
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool BuildPriority::readPressure(const std::string &resource, double &avg10)
+{
+    std::vector<std::string> lines;
+    if (!FileUtils::getFileLines("/proc/pressure/" + resource, lines))
+    {
+        return false;
+    }
+    for (const std::string &line : lines)
+    {
+        if (StringUtils::startsWith(line, "some ") && 1 == sscanf(line.c_str(), "some avg10=%lf", &avg10))
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+#include "BuildRoot.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/HashUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/SystemUtils.h"
+
+// written into every build tree below the root: the package path, its mtime the last use
+static const char *s_stamp_file = ".cmake_tool_package";
+
+void BuildRoot::setRootDirectory(const std::string &root_dir)
+{
+    m_rootDir = root_dir;
+    if (!m_rootDir.empty() && m_rootDir.front() == '~')
+    {
+        m_rootDir.replace(0, 1, SystemUtils::getEnv("HOME"));
+    }
+}
+
+void BuildRoot::setMinFreeBytes(std::uint64_t min_free_bytes)
+{
+    m_minFreeBytes = min_free_bytes;
+}
+
+std::string BuildRoot::getBuildPath(const std::string &package_path) const
+{
+    if (m_rootDir.empty())
+    {
+        return FileUtils::buildFilePath(package_path, "build/");
+    }
+    std::string name = FileUtils::getFileName(package_path) + "-" + HashUtils::sha256(package_path).substr(0, 16);
+    return FileUtils::buildFilePath(m_rootDir, name + "/");
+}
+
+void BuildRoot::markUsed(const std::string &package_path)
+{
+    if (m_rootDir.empty())
+    {
+        return;
+    }
+    std::string build_path = getBuildPath(package_path);
+    FileUtils::createDirectory(build_path);
+    FileUtils::writeFileContents(FileUtils::buildFilePath(build_path, s_stamp_file), package_path + "\n");
+}
+
+std::uint64_t BuildRoot::_getFreeBytes() const
+{
+    struct statvfs info;
+    if (statvfs(m_rootDir.c_str(), &info) != 0)
+    {
+        return UINT64_MAX;
+    }
+    return static_cast<std::uint64_t>(info.f_bavail) * info.f_frsize;
+}
+
+void BuildRoot::evict(const std::set<std::string> &keep_build_paths)
+{
+    if (m_rootDir.empty() || m_minFreeBytes == 0 || !FileUtils::isDirectory(m_rootDir))
+    {
+        return;
+    }
+
+    std::uint64_t free_bytes = _getFreeBytes();
+    if (free_bytes >= m_minFreeBytes)
+    {
+        return;
+    }
+
+    // least recently built first
+    std::vector<std::pair<time_t, std::string>> build_trees;
+    for (const std::string &dir : FileUtils::getFolderEntries(m_rootDir))
+    {
+        std::string build_path = dir + "/";
+        if (keep_build_paths.count(build_path))
+        {
+            continue;
+        }
+        struct stat stamp_stat;
+        if (stat(FileUtils::buildFilePath(build_path, s_stamp_file).c_str(), &stamp_stat) == 0)
+        {
+            build_trees.emplace_back(stamp_stat.st_mtime, build_path);
+        }
+    }
+    std::sort(build_trees.begin(), build_trees.end());
+
+    for (const auto &build_tree : build_trees)
+    {
+        if (free_bytes >= m_minFreeBytes)
+        {
+            break;
+        }
+        std::cout << "Evict build tree \"" << build_tree.second << "\" (" << (free_bytes >> 20) << " MiB free)" << std::endl;
+        FileUtils::deleteFolder(build_tree.second);
+        free_bytes = _getFreeBytes();
+    }
+}
+
+std::string BuildRoot::getDefaultRootDirectory()
+{
+    std::string cache_home = SystemUtils::getEnv("XDG_CACHE_HOME");
+    if (cache_home.empty())
+    {
+        cache_home = FileUtils::buildFilePath(SystemUtils::getEnv("HOME"), ".cache");
+    }
+    return FileUtils::buildFilePath(cache_home, "cmake_tool/build");
+}
+
+std::uint64_t BuildRoot::parseSize(const std::string &size_string)
+{
+    std::string value = StringUtils::toUpperTrimmed(size_string);
+    if (value.empty())
+    {
+        return 0;
+    }
+
+    std::uint64_t scale = 1;
+    switch (value.back())
+    {
+    case 'T':
+        scale <<= 10;
+        // fall through
+    case 'G':
+        scale <<= 10;
+        // fall through
+    case 'M':
+        scale <<= 10;
+        // fall through
+    case 'K':
+        scale <<= 10;
+        value.pop_back();
+        break;
+    default:
+        break;
+    }
+    return static_cast<std::uint64_t>(strtoull(value.c_str(), nullptr, 10)) * scale;
+}
@@ -0,0 +1,202 @@
+#include <chrono>
+#include <thread>
+
+#include "BuildScheduler.hpp"
+
+static const size_t s_stage_count = 3;
+// how often held back jobs ask the admission check again
+static const std::chrono::milliseconds s_admission_poll(1000);
+
+BuildScheduler::BuildScheduler(size_t configure_jobs, size_t build_jobs, size_t install_jobs)
+{
+    m_stageLimits[static_cast<size_t>(BuildStage::CONFIGURE)] = configure_jobs > 0 ? configure_jobs : 1;
+    m_stageLimits[static_cast<size_t>(BuildStage::BUILD)] = build_jobs > 0 ? build_jobs : 1;
+    m_stageLimits[static_cast<size_t>(BuildStage::INSTALL)] = install_jobs > 0 ? install_jobs : 1;
+}
+
+size_t BuildScheduler::addJob(const std::string &package_path, const std::string &build_path, const std::string &variant)
+{
+    BuildJob job;
+    job.package_path = package_path;
+    job.build_path = build_path;
+    job.variant = variant;
+    m_jobs.emplace_back(job);
+    return m_jobs.size() - 1;
+}
+
+void BuildScheduler::addDependency(size_t job_index, size_t dependency_index)
+{
+    if (job_index != dependency_index)
+    {
+        m_jobs[job_index].dependencies.emplace_back(dependency_index);
+    }
+}
+
+void BuildScheduler::setAdmissionCheck(const AdmissionCheck &check)
+{
+    m_admissionCheck = check;
+}
+
+const char *BuildScheduler::getStageName(BuildStage stage)
+{
+    switch (stage)
+    {
+    case BuildStage::CONFIGURE:
+        return "configure";
+    case BuildStage::BUILD:
+        return "build";
+    case BuildStage::INSTALL:
+        return "install";
+    }
+    return "unknown";
+}
+
+const char *BuildScheduler::getStateName(BuildJobState state)
+{
+    switch (state)
+    {
+    case BuildJobState::PENDING:
+        return "pending";
+    case BuildJobState::RUNNING:
+        return "running";
+    case BuildJobState::SUCCEEDED:
+        return "success";
+    case BuildJobState::CACHED:
+        return "cached";
+    case BuildJobState::FAILED:
+        return "failed";
+    case BuildJobState::SKIPPED:
+        return "skipped";
+    }
+    return "unknown";
+}
+
+bool BuildScheduler::_isReady(const BuildJob &job) const
+{
+    if (job.next_stage != static_cast<size_t>(BuildStage::CONFIGURE))
+    {
+        return true;
+    }
+    for (size_t dependency : job.dependencies)
+    {
+        BuildJobState state = m_jobs[dependency].state;
+        if (state != BuildJobState::SUCCEEDED && state != BuildJobState::CACHED)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BuildScheduler::_skipBlockedJobs()
+{
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (BuildJob &job : m_jobs)
+        {
+            if (job.state != BuildJobState::PENDING)
+            {
+                continue;
+            }
+            for (size_t dependency : job.dependencies)
+            {
+                BuildJobState state = m_jobs[dependency].state;
+                if (state == BuildJobState::FAILED || state == BuildJobState::SKIPPED)
+                {
+                    job.state = BuildJobState::SKIPPED;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void BuildScheduler::run(const StageRunner &runner)
+{
+    std::vector<std::thread> workers;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        _skipBlockedJobs();
+
+        // later stages first, so packages already in flight finish before new ones start
+        bool started = false;
+        bool held_back = false;
+        for (size_t stage = s_stage_count; stage-- > 0;)
+        {
+            for (size_t index = 0; index < m_jobs.size() && m_stageRunning[stage] < m_stageLimits[stage]; ++index)
+            {
+                BuildJob &job = m_jobs[index];
+                if (job.state != BuildJobState::PENDING || job.next_stage != stage || !_isReady(job))
+                {
+                    continue;
+                }
+                if (stage == static_cast<size_t>(BuildStage::CONFIGURE) && m_admissionCheck && !m_admissionCheck())
+                {
+                    held_back = true;
+                    break;
+                }
+
+                job.state = BuildJobState::RUNNING;
+                ++m_stageRunning[stage];
+                started = true;
+                workers.emplace_back([this, &runner, index, stage]() {
+                    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    BuildStageResult result = runner(m_jobs[index], static_cast<BuildStage>(stage));
+                    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    BuildJob &finished_job = m_jobs[index];
+                    finished_job.stage_seconds[stage] = elapsed.count();
+                    --m_stageRunning[stage];
+                    if (result == BuildStageResult::FAILED)
+                    {
+                        finished_job.state = BuildJobState::FAILED;
+                    }
+                    else if (result == BuildStageResult::CACHED)
+                    {
+                        finished_job.state = BuildJobState::CACHED;
+                    }
+                    else if (++finished_job.next_stage >= s_stage_count)
+                    {
+                        finished_job.state = BuildJobState::SUCCEEDED;
+                    }
+                    else
+                    {
+                        finished_job.state = BuildJobState::PENDING;
+                    }
+                    m_condition.notify_all();
+                });
+            }
+        }
+
+        size_t running = 0;
+        for (size_t stage = 0; stage < s_stage_count; ++stage)
+        {
+            running += m_stageRunning[stage];
+        }
+        if (running == 0 && !started && !held_back)
+        {
+            // every remaining job is finished or blocked
+            break;
+        }
+        if (held_back)
+        {
+            m_condition.wait_for(lock, s_admission_poll);
+        }
+        else
+        {
+            m_condition.wait(lock);
+        }
+    }
+
+    lock.unlock();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
@@ -0,0 +1,143 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include "BuildStats.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/StringUtils.h"
+
+static const char *s_stats_header = "# cmake_tool build stats";
+
+double BuildRecord::getSeconds() const
+{
+    return stage_seconds[0] + stage_seconds[1] + stage_seconds[2];
+}
+
+ProcessUsage BuildRecord::getUsage() const
+{
+    ProcessUsage usage;
+    for (const ProcessUsage &stage : stage_usage)
+    {
+        usage.add(stage);
+    }
+    return usage;
+}
+
+static std::string _formatStage(double seconds, const ProcessUsage &usage)
+{
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), "%.3f,%.3f,%.3f,%llu,%llu,%llu", seconds, usage.user_seconds, usage.system_seconds,
+             static_cast<unsigned long long>(usage.max_rss_kb), static_cast<unsigned long long>(usage.block_input),
+             static_cast<unsigned long long>(usage.block_output));
+    return buffer;
+}
+
+static bool _parseStage(const std::string &field, double &seconds, ProcessUsage &usage)
+{
+    std::vector<std::string> values = StringUtils::split(field, ",");
+    if (values.size() != 6)
+    {
+        return false;
+    }
+    seconds = atof(values[0].c_str());
+    usage.user_seconds = atof(values[1].c_str());
+    usage.system_seconds = atof(values[2].c_str());
+    usage.max_rss_kb = strtoull(values[3].c_str(), nullptr, 10);
+    usage.block_input = strtoull(values[4].c_str(), nullptr, 10);
+    usage.block_output = strtoull(values[5].c_str(), nullptr, 10);
+    return true;
+}
+
+bool BuildStats::load(const std::string &stats_path)
+{
+    m_statsPath = stats_path;
+    m_records.clear();
+
+    std::vector<std::string> lines;
+    if (!FileUtils::fileExists(stats_path) || !FileUtils::getFileLines(stats_path, lines) ||
+        lines.empty() || lines.front() != s_stats_header)
+    {
+        return false;
+    }
+
+    for (size_t i = 1; i < lines.size(); ++i)
+    {
+        std::vector<std::string> fields = StringUtils::split(lines[i], "\t");
+        if (fields.size() != 7 && fields.size() != 8)
+        {
+            continue;
+        }
+        BuildRecord record;
+        record.state = fields[0];
+        record.time = atoll(fields[1].c_str());
+        bool valid = true;
+        for (size_t stage = 0; stage < 3; ++stage)
+        {
+            valid = valid && _parseStage(fields[2 + stage], record.stage_seconds[stage], record.stage_usage[stage]);
+        }
+        record.variant = fields[5];
+        record.package_path = fields[6];
+        if (fields.size() > 7)
+        {
+            std::vector<std::string> prefetch = StringUtils::split(fields[7], ",");
+            record.prefetch_seconds = atof(prefetch[0].c_str());
+            record.prefetch_bytes = prefetch.size() > 1 ? strtoull(prefetch[1].c_str(), nullptr, 10) : 0;
+        }
+        if (valid)
+        {
+            m_records.emplace_back(record);
+        }
+    }
+    return true;
+}
+
+bool BuildStats::save() const
+{
+    if (m_statsPath.empty())
+    {
+        return false;
+    }
+
+    std::string contents = std::string(s_stats_header) + "\n";
+    for (const BuildRecord &record : m_records)
+    {
+        contents += record.state + "\t" + std::to_string(record.time);
+        for (size_t stage = 0; stage < 3; ++stage)
+        {
+            contents += "\t" + _formatStage(record.stage_seconds[stage], record.stage_usage[stage]);
+        }
+        char prefetch[64];
+        snprintf(prefetch, sizeof(prefetch), "%.3f,%llu", record.prefetch_seconds, static_cast<unsigned long long>(record.prefetch_bytes));
+        contents += "\t" + record.variant + "\t" + record.package_path + "\t" + prefetch + "\n";
+    }
+
+    std::string temp_path = m_statsPath + ".tmp";
+    return FileUtils::writeFileContents(temp_path, contents) && 0 == std::rename(temp_path.c_str(), m_statsPath.c_str());
+}
+
+void BuildStats::addJob(const BuildJob &job, double prefetch_seconds, std::uint64_t prefetch_bytes)
+{
+    BuildRecord record;
+    record.package_path = job.package_path;
+    record.variant = job.variant;
+    record.state = BuildScheduler::getStateName(job.state);
+    record.time = static_cast<std::int64_t>(std::time(nullptr));
+    record.prefetch_seconds = prefetch_seconds;
+    record.prefetch_bytes = prefetch_bytes;
+    for (size_t stage = 0; stage < 3; ++stage)
+    {
+        record.stage_seconds[stage] = job.stage_seconds[stage];
+        record.stage_usage[stage] = job.stage_usage[stage];
+    }
+
+    for (BuildRecord &existing : m_records)
+    {
+        if (existing.package_path == record.package_path && existing.variant == record.variant)
+        {
+            existing = record;
+            return;
+        }
+    }
+    m_records.emplace_back(record);
+}
@@ -0,0 +1,228 @@
+#include <iostream>
+#include <thread>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "CacheServer.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/HashUtils.h"
+#include "utils/HttpUtils.h"
+#include "utils/StringUtils.h"
+
+static const int s_max_connections = 64;
+static const int s_connection_timeout_seconds = 60;
+
+CacheServer::CacheServer(const std::string &storage_dir, const std::string &bind_address, int port)
+: m_storageDir(storage_dir)
+, m_bindAddress(bind_address)
+, m_port(port)
+{
+}
+
+CacheServer::~CacheServer()
+{
+    stop();
+}
+
+bool CacheServer::run()
+{
+    FileUtils::createDirectory(FileUtils::buildFilePath(m_storageDir, "cas"));
+    FileUtils::createDirectory(FileUtils::buildFilePath(m_storageDir, "ac"));
+
+    m_listenFd = HttpUtils::listenOn(m_bindAddress, m_port);
+    if (m_listenFd < 0)
+    {
+        std::cerr << "!! cache-server failed: can not listen on " << m_bindAddress << ":" << m_port << " (" << strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    std::cout << "cache-server listening on http://" << m_bindAddress << ":" << m_port << "/, storage \"" << m_storageDir << "\"" << std::endl;
+    m_running = true;
+    while (m_running)
+    {
+        int fd = accept(m_listenFd, NULL, NULL);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        if (m_activeConnections >= s_max_connections)
+        {
+            _sendStatus(fd, 503, "Service Unavailable");
+            close(fd);
+            continue;
+        }
+
+        ++m_activeConnections;
+        std::thread([this, fd]() {
+            _handleConnection(fd);
+            close(fd);
+            --m_activeConnections;
+        }).detach();
+    }
+
+    return true;
+}
+
+void CacheServer::stop()
+{
+    m_running = false;
+    if (m_listenFd >= 0)
+    {
+        shutdown(m_listenFd, SHUT_RDWR);
+        close(m_listenFd);
+        m_listenFd = -1;
+    }
+}
+
+void CacheServer::_sendStatus(int fd, int status, const std::string &reason)
+{
+    std::string response = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n" +
+                           "Content-Length: 0\r\n" +
+                           "Connection: close\r\n\r\n";
+    HttpUtils::sendAll(fd, response.data(), response.size());
+}
+
+void CacheServer::_handleConnection(int fd)
+{
+    HttpUtils::setTimeout(fd, s_connection_timeout_seconds);
+
+    std::string headers;
+    std::string body_prefix;
+    if (!HttpUtils::readHeaders(fd, headers, body_prefix))
+    {
+        return;
+    }
+
+    // request line: METHOD /kind/key HTTP/1.1
+    std::string request_line = headers.substr(0, headers.find("\r\n"));
+    std::vector<std::string> parts = StringUtils::split(request_line, " ");
+    if (parts.size() < 3)
+    {
+        _sendStatus(fd, 400, "Bad Request");
+        return;
+    }
+
+    const std::string &method = parts[0];
+    std::vector<std::string> path_parts = StringUtils::split(parts[1], "/");
+    // "/cas/<key>" splits into "", "cas", "<key>"
+    if (path_parts.size() != 3 || !path_parts[0].empty() ||
+        (path_parts[1] != "cas" && path_parts[1] != "ac") ||
+        !HashUtils::isHexDigest(path_parts[2]))
+    {
+        _sendStatus(fd, 404, "Not Found");
+        return;
+    }
+
+    const std::string &kind = path_parts[1];
+    const std::string &key = path_parts[2];
+    std::string file_path = FileUtils::buildFilePath(FileUtils::buildFilePath(m_storageDir, kind), key);
+
+    if (method == "GET" || method == "HEAD")
+    {
+        _handleGet(fd, file_path, method == "HEAD");
+    }
+    else if (method == "PUT")
+    {
+        _handlePut(fd, kind, key, headers, body_prefix);
+    }
+    else
+    {
+        _sendStatus(fd, 405, "Method Not Allowed");
+    }
+}
+
+void CacheServer::_handleGet(int fd, const std::string &file_path, bool head_only)
+{
+    FILE *file = fopen(file_path.c_str(), "rb");
+    if (!file)
+    {
+        _sendStatus(fd, 404, "Not Found");
+        return;
+    }
+
+    std::string response = "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: application/octet-stream\r\n"
+                           "Content-Length: " + std::to_string(FileUtils::getFileSize(file_path)) + "\r\n" +
+                           "Connection: close\r\n\r\n";
+    bool ok = HttpUtils::sendAll(fd, response.data(), response.size());
+
+    char buffer[65536];
+    size_t bytes_read = 0;
+    while (ok && !head_only && (bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        ok = HttpUtils::sendAll(fd, buffer, bytes_read);
+    }
+    fclose(file);
+}
+
+void CacheServer::_handlePut(int fd, const std::string &kind, const std::string &key, const std::string &headers, const std::string &body_prefix)
+{
+    std::string length_value = HttpUtils::headerValue(headers, "Content-Length");
+    if (length_value.empty())
+    {
+        _sendStatus(fd, 411, "Length Required");
+        return;
+    }
+
+    std::uint64_t remaining = strtoull(length_value.c_str(), NULL, 10);
+    std::string file_path = FileUtils::buildFilePath(FileUtils::buildFilePath(m_storageDir, kind), key);
+    std::string temp_path = file_path + "." + StringUtils::createUUID() + ".tmp";
+
+    FILE *file = fopen(temp_path.c_str(), "wb");
+    if (!file)
+    {
+        _sendStatus(fd, 500, "Internal Server Error");
+        return;
+    }
+
+    HashUtils::Sha256 hasher;
+    bool ok = true;
+    size_t prefix_size = body_prefix.size() > remaining ? static_cast<size_t>(remaining) : body_prefix.size();
+    ok = fwrite(body_prefix.data(), 1, prefix_size, file) == prefix_size;
+    hasher.update(body_prefix.data(), prefix_size);
+    remaining -= prefix_size;
+
+    char buffer[65536];
+    while (ok && remaining > 0)
+    {
+        size_t wanted = remaining < sizeof(buffer) ? static_cast<size_t>(remaining) : sizeof(buffer);
+        ssize_t received = recv(fd, buffer, wanted, 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            ok = false;
+            break;
+        }
+        ok = fwrite(buffer, 1, static_cast<size_t>(received), file) == static_cast<size_t>(received);
+        hasher.update(buffer, static_cast<size_t>(received));
+        remaining -= static_cast<std::uint64_t>(received);
+    }
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok)
+    {
+        remove(temp_path.c_str());
+        _sendStatus(fd, 400, "Bad Request");
+        return;
+    }
+
+    if (kind == "cas" && hasher.hexDigest() != key)
+    {
+        remove(temp_path.c_str());
+        _sendStatus(fd, 400, "Digest Mismatch");
+        return;
+    }
+
+    FileUtils::renameFile(temp_path, file_path);
+    _sendStatus(fd, 200, "OK");
+}
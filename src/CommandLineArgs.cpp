@@ -164,7 +164,9 @@ size_t CommandLineArgs::getOptionStep(const std::string &string_input) const
     {
         if (find && m_string_inputs[i].at(0) == '-')
         {
+            // option values end at the next option
             end = i;
+            break;
         }
         if (!find && m_string_inputs[i] == string_input)
         {
@@ -269,7 +271,7 @@ void CommandLineArgs::printHelp()
 
     std::cout << std::endl;
     std::cout << "=========================================================" << std::endl;
-    if (m_title.find(" list") != m_title.npos || m_title.find(" reset") != m_title.npos)
+    if (m_title.find(" list") != m_title.npos || m_title.find(" reset") != m_title.npos || m_title.find(" cache-server") != m_title.npos)
     {
         std::cout << "Usage: " << m_title << " [options]" << std::endl << std::endl;
     }
@@ -307,10 +309,13 @@ std::string CommandLineArgs::CommandLineOpt::toString(int first_column_width, in
     {
         return long_name + " [" + short_name + "]: \t" + StringUtils::repeat(" ", spaces) + description;
     }
-    char output_str[128];
-    snprintf(output_str, sizeof(output_str) - 1, "%-*s %s", first_column_width, ("  " + long_name + " [" + short_name + "]:").c_str(), (StringUtils::repeat(" ", spaces) + description).c_str());
-    return output_str;
-
+    // the descriptions have no length limit, pad the first column without a fixed size buffer
+    std::string output_str = "  " + long_name + " [" + short_name + "]:";
+    if (static_cast<int>(output_str.size()) < first_column_width)
+    {
+        output_str.append(first_column_width - output_str.size(), ' ');
+    }
+    return output_str + " " + StringUtils::repeat(" ", spaces) + description;
 }
 
 size_t CommandLineArgs::CommandLineOpt::getAttachArgsNumber() const
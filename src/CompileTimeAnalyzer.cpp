@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "CompileTimeAnalyzer.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/JsonStreamParser.h"
+#include "utils/StringUtils.h"
+
+typedef JsonStreamParser::Token Token;
+
+// reads a value, returning the closing token for objects and arrays
+static Token _nextScalar(JsonStreamParser &parser)
+{
+    size_t depth = parser.depth();
+    Token token = parser.next();
+    while (parser.depth() > depth && token != Token::ERROR && token != Token::END)
+    {
+        token = parser.next();
+    }
+    return token;
+}
+
+// the traces of all targets below dir_path, in subdirectories too (components, bench/);
+// the build trees of other variants nested in it have their own CMakeCache.txt and are left out
+static void _collectTraceFiles(const std::string &dir_path, bool in_target, std::vector<std::string> &trace_files)
+{
+    DIR *dir = opendir(dir_path.c_str());
+    if (NULL == dir)
+    {
+        return;
+    }
+
+    struct dirent *dp;
+    while ((dp = readdir(dir)) != NULL)
+    {
+        std::string name(dp->d_name);
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+        std::string path = FileUtils::buildFilePath(dir_path, name);
+        struct stat st;
+        if (lstat(path.c_str(), &st) != 0)
+        {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode))
+        {
+            if (!FileUtils::fileExists(FileUtils::buildFilePath(path, "CMakeCache.txt")))
+            {
+                _collectTraceFiles(path, in_target || StringUtils::endsWith(name, ".dir"), trace_files);
+            }
+        }
+        else if (in_target && S_ISREG(st.st_mode) && StringUtils::endsWith(name, ".json"))
+        {
+            trace_files.emplace_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+void CompileTimeAnalyzer::_addEvent(const std::string &name, const std::string &detail, std::uint64_t duration_us, const std::string &unit_name)
+{
+    if (name == "Source")
+    {
+        // inclusive time of parsing a header and everything it includes
+        CompileTimeEntry &entry = m_headers[detail];
+        entry.total_us += duration_us;
+        ++entry.count;
+    }
+    else if (name == "InstantiateClass" || name == "InstantiateFunction")
+    {
+        CompileTimeEntry &entry = m_templates[detail];
+        entry.total_us += duration_us;
+        ++entry.count;
+    }
+    else if (name == "ExecuteCompiler")
+    {
+        CompileTimeEntry &entry = m_units[unit_name];
+        entry.total_us += duration_us;
+        ++entry.count;
+    }
+    else if (name == "Frontend")
+    {
+        m_frontendUs += duration_us;
+    }
+    else if (name == "Backend")
+    {
+        m_backendUs += duration_us;
+    }
+    else if (StringUtils::startsWith(name, "Total Instantiate"))
+    {
+        m_templateUs += duration_us;
+    }
+}
+
+bool CompileTimeAnalyzer::addTraceFile(const std::string &trace_path, const std::string &unit_name)
+{
+    JsonStreamParser parser;
+    if (!parser.open(trace_path) || parser.next() != Token::OBJECT_BEGIN)
+    {
+        ++m_failedCount;
+        return false;
+    }
+
+    bool found_events = false;
+    Token token;
+    while ((token = parser.next()) == Token::KEY)
+    {
+        if (parser.value() != "traceEvents")
+        {
+            if (!parser.skipValue())
+            {
+                break;
+            }
+            continue;
+        }
+        if (parser.next() != Token::ARRAY_BEGIN)
+        {
+            break;
+        }
+        found_events = true;
+
+        // one complete ("X") event per object, nested values other than "args" are skipped
+        while ((token = parser.next()) == Token::OBJECT_BEGIN)
+        {
+            std::string name, phase, detail;
+            std::uint64_t duration_us = 0;
+            while ((token = parser.next()) == Token::KEY)
+            {
+                std::string key = parser.value();
+                if (key == "args")
+                {
+                    size_t depth = parser.depth();
+                    while ((token = parser.next()) != Token::ERROR && token != Token::END && parser.depth() > depth)
+                    {
+                        if (token == Token::KEY && parser.value() == "detail" && parser.depth() == depth + 1 &&
+                            _nextScalar(parser) == Token::STRING)
+                        {
+                            detail = parser.value();
+                        }
+                    }
+                    if (token == Token::ERROR || token == Token::END)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                token = _nextScalar(parser);
+                if (key == "name" && token == Token::STRING)
+                {
+                    name = parser.value();
+                }
+                else if (key == "ph" && token == Token::STRING)
+                {
+                    phase = parser.value();
+                }
+                else if (key == "dur" && token == Token::NUMBER)
+                {
+                    duration_us = strtoull(parser.value().c_str(), nullptr, 10);
+                }
+                else if (token == Token::ERROR || token == Token::END)
+                {
+                    break;
+                }
+            }
+            if (token != Token::OBJECT_END)
+            {
+                break;
+            }
+            if (phase == "X")
+            {
+                _addEvent(name, detail, duration_us, unit_name);
+            }
+        }
+        if (token != Token::ARRAY_END)
+        {
+            break;
+        }
+    }
+
+    if (token != Token::OBJECT_END || !found_events)
+    {
+        ++m_failedCount;
+        return false;
+    }
+    ++m_traceCount;
+    return true;
+}
+
+size_t CompileTimeAnalyzer::addBuildTree(const std::string &build_path, const std::string &label)
+{
+    // traces sit next to the object files: [<subdir>/]CMakeFiles/<target>.dir/<source>.json
+    std::vector<std::string> trace_files;
+    _collectTraceFiles(build_path, false, trace_files);
+    std::sort(trace_files.begin(), trace_files.end());
+    size_t added = 0;
+    for (const std::string &trace_path : trace_files)
+    {
+        size_t pos = trace_path.find(".dir/");
+        if (pos == std::string::npos)
+        {
+            continue;
+        }
+        size_t target_pos = trace_path.rfind('/', pos);
+        std::string unit_name = trace_path.substr(target_pos == std::string::npos ? 0 : target_pos + 1);
+        unit_name = label + ": " + unit_name.substr(0, unit_name.size() - 5);
+        if (addTraceFile(trace_path, unit_name))
+        {
+            ++added;
+        }
+    }
+    return added;
+}
+
+void CompileTimeAnalyzer::_printTop(const char *title, const std::map<std::string, CompileTimeEntry> &entries, size_t top_count)
+{
+    if (entries.empty())
+    {
+        return;
+    }
+
+    std::vector<std::map<std::string, CompileTimeEntry>::const_iterator> sorted;
+    std::uint64_t total_us = 0;
+    size_t total_count = 0;
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        sorted.emplace_back(it);
+        total_us += it->second.total_us;
+        total_count += it->second.count;
+    }
+    size_t shown = std::min(top_count, sorted.size());
+    std::partial_sort(sorted.begin(), sorted.begin() + shown, sorted.end(), [](const std::map<std::string, CompileTimeEntry>::const_iterator &a,
+                                                                              const std::map<std::string, CompileTimeEntry>::const_iterator &b) {
+        return a->second.total_us > b->second.total_us;
+    });
+
+    printf("\n%s: %zu distinct, %zu total, %.2fs\n", title, entries.size(), total_count, total_us / 1e6);
+    printf("    %10s %8s %10s  %s\n", "total", "count", "average", "name");
+    for (size_t i = 0; i < shown; ++i)
+    {
+        const CompileTimeEntry &entry = sorted[i]->second;
+        printf("    %9.3fs %8zu %9.1fms  %s\n", entry.total_us / 1e6, entry.count, entry.total_us / 1e3 / entry.count, sorted[i]->first.c_str());
+    }
+}
+
+void CompileTimeAnalyzer::print(size_t top_count) const
+{
+    printf("\nCompile time analysis: %zu traces", m_traceCount);
+    if (m_failedCount > 0)
+    {
+        printf(", %zu unreadable", m_failedCount);
+    }
+    printf("\n    frontend %.2fs, backend %.2fs, template instantiation %.2fs\n", m_frontendUs / 1e6, m_backendUs / 1e6, m_templateUs / 1e6);
+
+    _printTop("Most expensive translation units", m_units, top_count);
+    _printTop("Most expensive headers (inclusive parse time)", m_headers, top_count);
+    _printTop("Most expensive template instantiations", m_templates, top_count);
+    if (m_headers.empty() && m_templates.empty() && m_traceCount > 0)
+    {
+        printf("\n    header and template details need clang's -ftime-trace.\n");
+    }
+}
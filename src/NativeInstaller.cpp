@@ -0,0 +1,274 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "NativeInstaller.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/HashUtils.h"
+#include "utils/SystemUtils.h"
+
+static const char *s_stage_dir = "cmake_tool_stage";
+static const char *s_manifest_file = "install_manifest.txt";
+
+static bool _sameTime(const struct timespec &a, const struct timespec &b)
+{
+    return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+static std::string _temporaryPath(const std::string &install_path)
+{
+    return FileUtils::getDirPath(install_path) + "." + FileUtils::getFileName(install_path) + ".cmake_tool-" +
+           std::to_string(getpid());
+}
+
+static bool _makeParentDirectory(const std::string &path)
+{
+    std::string dir_path = FileUtils::getDirPath(path);
+    return dir_path.empty() || FileUtils::isDirectory(dir_path) || FileUtils::createDirectory(dir_path);
+}
+
+NativeInstaller::NativeInstaller(const std::string &build_path)
+    : m_buildPath(build_path)
+    , m_stagePath(FileUtils::buildFilePath(build_path, s_stage_dir))
+{
+}
+
+bool NativeInstaller::_stage(const std::string &log_path, ProcessUsage *usage)
+{
+    // DESTDIR keeps the real prefix in RPATHs and absolute destinations. CMake
+    // skips files within a second of their staged copy, which a quick rebuild
+    // produces; the stage is local and cheap, so always copy and let the sync
+    // compare the contents
+    std::string cmd = "cd \"" + m_buildPath + "\" && CMAKE_INSTALL_ALWAYS=1 DESTDIR=\"" + m_stagePath + "\" cmake -P cmake_install.cmake";
+    return 0 == SystemUtils::executeShell(cmd, log_path, usage);
+}
+
+void NativeInstaller::_readInstallFiles(std::vector<std::string> &install_files)
+{
+    // cmake_install.cmake lists this run's files, without DESTDIR
+    std::vector<std::string> lines;
+    FileUtils::getFileLines(FileUtils::buildFilePath(m_buildPath, s_manifest_file), lines);
+    for (const std::string &line : lines)
+    {
+        if (!line.empty() && line.front() == '/')
+        {
+            install_files.emplace_back(line);
+        }
+    }
+}
+
+bool NativeInstaller::_copyToTemporary(const std::string &staged_path, const std::string &temp_path, bool &cloned)
+{
+    int in_fd = open(staged_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in_fd < 0)
+    {
+        return false;
+    }
+    struct stat in_stat;
+    if (fstat(in_fd, &in_stat) != 0)
+    {
+        close(in_fd);
+        return false;
+    }
+    int out_fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, in_stat.st_mode & 07777);
+    if (out_fd < 0)
+    {
+        close(in_fd);
+        return false;
+    }
+
+    bool success = true;
+    cloned = ioctl(out_fd, FICLONE, in_fd) == 0;
+    if (!cloned)
+    {
+        off_t remaining = in_stat.st_size;
+        bool use_copy_range = true;
+        while (remaining > 0)
+        {
+            ssize_t copied = -1;
+            if (use_copy_range)
+            {
+                copied = copy_file_range(in_fd, nullptr, out_fd, nullptr, remaining, 0);
+                if (copied < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+                {
+                    // not supported between these file systems, copy through user space
+                    use_copy_range = false;
+                    continue;
+                }
+            }
+            else
+            {
+                char buffer[64 * 1024];
+                copied = read(in_fd, buffer, sizeof(buffer));
+                if (copied > 0 && write(out_fd, buffer, copied) != copied)
+                {
+                    copied = -1;
+                }
+            }
+            if (copied < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (copied <= 0)
+            {
+                success = false;
+                break;
+            }
+            remaining -= copied;
+        }
+    }
+
+    // the mode is filtered by umask on open, and the staged time marks the file as synced
+    struct timespec times[2] = {in_stat.st_atim, in_stat.st_mtim};
+    success = success && fchmod(out_fd, in_stat.st_mode & 07777) == 0 && futimens(out_fd, times) == 0;
+    if (close(out_fd) != 0)
+    {
+        success = false;
+    }
+    close(in_fd);
+    if (success)
+    {
+        m_stats.bytes_written += cloned ? 0 : in_stat.st_size;
+    }
+    return success;
+}
+
+bool NativeInstaller::_syncSymlink(const std::string &staged_path, const std::string &install_path)
+{
+    char target[4096];
+    ssize_t length = readlink(staged_path.c_str(), target, sizeof(target) - 1);
+    if (length < 0)
+    {
+        return false;
+    }
+    target[length] = '\0';
+
+    char installed_target[4096];
+    ssize_t installed_length = readlink(install_path.c_str(), installed_target, sizeof(installed_target) - 1);
+    if (installed_length == length && 0 == memcmp(target, installed_target, length))
+    {
+        ++m_stats.unchanged;
+        return true;
+    }
+
+    std::string temp_path = _temporaryPath(install_path);
+    unlink(temp_path.c_str());
+    if (!_makeParentDirectory(install_path) || symlink(target, temp_path.c_str()) != 0 ||
+        rename(temp_path.c_str(), install_path.c_str()) != 0)
+    {
+        unlink(temp_path.c_str());
+        return false;
+    }
+    ++m_stats.updated;
+    return true;
+}
+
+bool NativeInstaller::_syncFile(const std::string &staged_path, const std::string &install_path)
+{
+    struct stat staged_stat;
+    if (lstat(staged_path.c_str(), &staged_stat) != 0)
+    {
+        return false;
+    }
+    if (S_ISLNK(staged_stat.st_mode))
+    {
+        return _syncSymlink(staged_path, install_path);
+    }
+
+    struct stat installed_stat;
+    if (lstat(install_path.c_str(), &installed_stat) == 0 && S_ISREG(installed_stat.st_mode) &&
+        installed_stat.st_size == staged_stat.st_size &&
+        (installed_stat.st_mode & 07777) == (staged_stat.st_mode & 07777))
+    {
+        // the staged times are whole seconds: a match only proves the contents when the installed
+        // copy was written after that second, a rebuild within it gets the same time
+        if (_sameTime(installed_stat.st_mtim, staged_stat.st_mtim) && installed_stat.st_ctim.tv_sec > staged_stat.st_mtim.tv_sec)
+        {
+            ++m_stats.unchanged;
+            return true;
+        }
+        if (HashUtils::sha256File(install_path) == HashUtils::sha256File(staged_path))
+        {
+            // same contents, take over the staged time so the next check is cheap
+            struct timespec times[2] = {installed_stat.st_atim, staged_stat.st_mtim};
+            utimensat(AT_FDCWD, install_path.c_str(), times, AT_SYMLINK_NOFOLLOW);
+            ++m_stats.unchanged;
+            return true;
+        }
+    }
+
+    std::string temp_path = _temporaryPath(install_path);
+    bool cloned = false;
+    if (!_makeParentDirectory(install_path) || !_copyToTemporary(staged_path, temp_path, cloned) ||
+        rename(temp_path.c_str(), install_path.c_str()) != 0)
+    {
+        int error = errno;
+        unlink(temp_path.c_str());
+        errno = error;
+        return false;
+    }
+    ++m_stats.updated;
+    if (cloned)
+    {
+        ++m_stats.cloned;
+    }
+    return true;
+}
+
+bool NativeInstaller::install(const std::string &log_path, ProcessUsage *usage)
+{
+    m_stats = Stats();
+    if (!_stage(log_path, usage))
+    {
+        return false;
+    }
+
+    std::vector<std::string> install_files;
+    _readInstallFiles(install_files);
+
+    std::string manifest;
+    for (const std::string &install_path : install_files)
+    {
+        if (_syncFile(m_stagePath + install_path, install_path))
+        {
+            manifest += (manifest.empty() ? "" : "\n") + install_path;
+        }
+        else
+        {
+            ++m_stats.failed;
+            std::string message = "Error: install \"" + install_path + "\" failed: " + strerror(errno);
+            if (log_path.empty())
+            {
+                std::cerr << message << std::endl;
+            }
+            else
+            {
+                FileUtils::appendToFile(log_path, message + "\n");
+            }
+        }
+    }
+
+    // the installed paths, as `make install` would have written them (no trailing newline)
+    FileUtils::writeFileContents(FileUtils::buildFilePath(m_buildPath, s_manifest_file), manifest);
+
+    std::string summary = "-- Native install: " + std::to_string(m_stats.updated) + " updated (" +
+                          std::to_string(m_stats.cloned) + " reflinked), " + std::to_string(m_stats.unchanged) +
+                          " unchanged, " + std::to_string(m_stats.bytes_written) + " bytes written";
+    if (log_path.empty())
+    {
+        std::cout << summary << std::endl;
+    }
+    else
+    {
+        FileUtils::appendToFile(log_path, summary + "\n");
+    }
+    return m_stats.failed == 0;
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+
+#include "PackageGraph.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/StringUtils.h"
+
+void PackageGraph::addPackage(const std::string &package_path)
+{
+    if (m_dependencies.find(package_path) == m_dependencies.end())
+    {
+        m_packagePaths.emplace_back(package_path);
+        m_dependencies[package_path];
+        m_dependents[package_path];
+    }
+}
+
+std::set<std::string> PackageGraph::_scanFindPackages(const std::string &package_path)
+{
+    std::vector<std::string> cmake_files = {FileUtils::buildFilePath(package_path, "CMakeLists.txt")};
+    for (const std::string &file : FileUtils::getFileEntries(package_path, ".cmake"))
+    {
+        cmake_files.emplace_back(file);
+    }
+
+    std::set<std::string> names;
+    for (const std::string &cmake_file : cmake_files)
+    {
+        for (std::string line : FileUtils::getFileLines(cmake_file))
+        {
+            line = line.substr(0, line.find('#'));
+            std::string lower_line = StringUtils::toLower(line);
+            size_t pos = lower_line.find("find_package");
+            if (pos == std::string::npos)
+            {
+                continue;
+            }
+            pos = lower_line.find('(', pos);
+            if (pos == std::string::npos)
+            {
+                continue;
+            }
+            std::string args = StringUtils::trimmed(lower_line.substr(pos + 1));
+            size_t end = args.find_first_of(" \t)");
+            std::string name = args.substr(0, end);
+            if (!name.empty())
+            {
+                names.insert(name);
+            }
+        }
+    }
+    return names;
+}
+
+void PackageGraph::resolve()
+{
+    std::map<std::string, std::vector<std::string>> paths_by_name;
+    for (const std::string &package_path : m_packagePaths)
+    {
+        paths_by_name[StringUtils::toLower(FileUtils::getFileName(package_path))].emplace_back(package_path);
+    }
+
+    for (const std::string &package_path : m_packagePaths)
+    {
+        for (const std::string &name : _scanFindPackages(package_path))
+        {
+            auto it = paths_by_name.find(name);
+            if (it == paths_by_name.end())
+            {
+                continue;
+            }
+            for (const std::string &dependency_path : it->second)
+            {
+                if (dependency_path != package_path)
+                {
+                    m_dependencies[package_path].insert(dependency_path);
+                    m_dependents[dependency_path].insert(package_path);
+                }
+            }
+        }
+    }
+}
+
+bool PackageGraph::contains(const std::string &package_path) const
+{
+    return m_dependencies.find(package_path) != m_dependencies.end();
+}
+
+const std::set<std::string> &PackageGraph::getDependencies(const std::string &package_path) const
+{
+    static const std::set<std::string> s_empty;
+    auto it = m_dependencies.find(package_path);
+    return it == m_dependencies.end() ? s_empty : it->second;
+}
+
+std::set<std::string> PackageGraph::getDependents(const std::string &package_path) const
+{
+    std::set<std::string> dependents;
+    std::vector<std::string> pending = {package_path};
+    while (!pending.empty())
+    {
+        std::string current = pending.back();
+        pending.pop_back();
+        auto it = m_dependents.find(current);
+        if (it == m_dependents.end())
+        {
+            continue;
+        }
+        for (const std::string &dependent : it->second)
+        {
+            if (dependents.insert(dependent).second)
+            {
+                pending.emplace_back(dependent);
+            }
+        }
+    }
+    dependents.erase(package_path);
+    return dependents;
+}
+
+std::vector<std::string> PackageGraph::sort(const std::vector<std::string> &package_paths) const
+{
+    // stable topological order: keep the given order unless a dependency has to go first
+    std::vector<std::string> sorted;
+    std::vector<std::string> remaining = package_paths;
+    std::set<std::string> subset(package_paths.begin(), package_paths.end());
+    std::set<std::string> emitted;
+
+    while (!remaining.empty())
+    {
+        auto ready = std::find_if(remaining.begin(), remaining.end(), [&](const std::string &path) {
+            for (const std::string &dependency : getDependencies(path))
+            {
+                if (subset.count(dependency) && !emitted.count(dependency))
+                {
+                    return false;
+                }
+            }
+            return true;
+        });
+        // a dependency cycle, fall back to the given order
+        if (ready == remaining.end())
+        {
+            ready = remaining.begin();
+        }
+        emitted.insert(*ready);
+        sorted.emplace_back(*ready);
+        remaining.erase(ready);
+    }
+    return sorted;
+}
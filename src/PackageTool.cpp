@@ -1,16 +1,37 @@
 #include <iostream>
 #include <numeric>
 #include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+
+#include <sys/utsname.h>
 
 #include "PackageTool.hpp"
+#include "BenchmarkReport.hpp"
+#include "BuildStats.hpp"
+#include "CompileTimeAnalyzer.hpp"
+#include "NativeInstaller.hpp"
+#include "PackageGraph.hpp"
+#include "PchAdvisor.hpp"
+#include "PackageWatcher.hpp"
+#include "SourcePrefetcher.hpp"
+#include "SourceSync.hpp"
 
 #include "utils/Exception.hpp"
+#include "utils/HashUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/FileUtils.h"
 #include "utils/SystemUtils.h"
 
 static std::ofstream g_log;
 static std::fstream g_create_info;
+// serializes terminal and log output of concurrent build stages
+static std::mutex g_output_mutex;
 
 std::string _executeCmd(const std::string &strCmd)
 {
@@ -42,6 +63,37 @@ std::string _executeCmd(const std::string &strCmd)
     return result;
 }
 
+static std::string _formatMemory(std::uint64_t size_kb)
+{
+    char buffer[32];
+    if (size_kb >= (1u << 20))
+    {
+        snprintf(buffer, sizeof(buffer), "%.1f GiB", size_kb / 1048576.0);
+    }
+    else
+    {
+        snprintf(buffer, sizeof(buffer), "%.1f MiB", size_kb / 1024.0);
+    }
+    return buffer;
+}
+
+// the traced copy of a variant, 'build --analyze-compile-time'
+static const std::string s_analyze_variant = "analyze";
+
+static std::string _getInstalledVariant(const std::string &variant)
+{
+    // traced builds are not installed, they use the dependencies of the variant they trace
+    if (variant == s_analyze_variant)
+    {
+        return "";
+    }
+    if (StringUtils::endsWith(variant, "/" + s_analyze_variant))
+    {
+        return variant.substr(0, variant.size() - s_analyze_variant.size() - 1);
+    }
+    return variant;
+}
+
 PackageTool::PackageTool(bool enable_log)
 {
     if (enable_log)
@@ -87,6 +139,40 @@ void PackageTool::setForce(bool enable_force)
     m_force = enable_force;
 }
 
+void PackageTool::setCreateOptions(const CreateOptions &create_options)
+{
+    m_createOptions = create_options;
+}
+
+void PackageTool::setBuildOptions(const BuildOptions &build_options)
+{
+    m_buildOptions = build_options;
+    if (!m_buildOptions.remote_cache_url.empty())
+    {
+        m_buildOptions.use_cache = true;
+        m_artifactCache.setRemoteUrl(m_buildOptions.remote_cache_url);
+    }
+
+    if (m_buildOptions.analyze_compile_time > 0)
+    {
+        // build every variant once more with traces in a build tree of its own, the regular builds and installs go on as usual
+        if (m_buildOptions.variants.empty())
+        {
+            m_buildOptions.variants.emplace_back(BuildVariant());
+        }
+        std::string trace_include = FileUtils::buildFilePath(FileUtils::getDirPath(m_createInfoPath), "time_trace.cmake");
+        size_t variant_count = m_buildOptions.variants.size();
+        for (size_t index = 0; index < variant_count; ++index)
+        {
+            BuildVariant build_variant = m_buildOptions.variants[index];
+            build_variant.name = build_variant.name.empty() ? s_analyze_variant : build_variant.name + "/" + s_analyze_variant;
+            build_variant.cmake_args.emplace_back("-DCMAKE_PROJECT_INCLUDE=\"" + trace_include + "\"");
+            build_variant.install = false;
+            m_buildOptions.variants.emplace_back(build_variant);
+        }
+    }
+}
+
 void PackageTool::_updateCurrentPackage(const std::string &package_path, const PackageType &package_type)
 {
     m_currentPackage.path = FileUtils::getAbsolutePath(package_path);
@@ -112,9 +198,40 @@ bool PackageTool::_isValidTemplatePath(const std::string &path)
     // CPP Path
     m_cppCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_application.cmake.in");
     m_cppMainPath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_main.cpp.in");
+    m_cppPchPath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_pch.hpp.in");
+    m_cppModulesCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_modules.cmake.in");
+    m_cppModulePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_module.cppm.in");
+    m_cppModulesMainPath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_modules_main.cpp.in");
+    // Modular layout Path
+    m_cppModularCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_modular.cmake.in");
+    m_cppModularMainPath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_modular_main.cpp.in");
+    m_cppComponentCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_component.cmake.in");
+    m_cppComponentHeaderPath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_component.hpp.in");
+    m_cppComponentSourcePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_component.cpp.in");
+    // Real-time Path
+    m_rtCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_rt.cmake.in");
+    m_rtSupportPath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_rt_support.hpp.in");
+    m_rtMainPath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_rt_main.cpp.in");
+    // Tracing Path
+    m_tracePath = FileUtils::buildFilePath(path, "share/cmake_tool/trace.hpp.in");
+    // Benchmark Path
+    m_benchCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/bench.cmake.in");
+    m_benchHeaderPath = FileUtils::buildFilePath(path, "share/cmake_tool/bench.hpp.in");
+    m_benchMainPath = FileUtils::buildFilePath(path, "share/cmake_tool/bench_main.cpp.in");
+    // Custom templates Path
+    m_templatesPath = FileUtils::buildFilePath(path, "share/cmake_tool/templates/");
+    // Build profile Path
+    m_profilePath = FileUtils::buildFilePath(path, "share/cmake_tool/cmake_tool_profile.cmake.in");
     // C Path
     m_cCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/c_application.cmake.in");
     m_cMainPath = FileUtils::buildFilePath(path, "share/cmake_tool/c_main.c.in");
+    // Library Path
+    m_cppLibCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_library.cmake.in");
+    m_cppLibHeaderPath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_library.hpp.in");
+    m_cppLibSourcePath = FileUtils::buildFilePath(path, "share/cmake_tool/c++_library.cpp.in");
+    m_cLibCMakePath = FileUtils::buildFilePath(path, "share/cmake_tool/c_library.cmake.in");
+    m_cLibHeaderPath = FileUtils::buildFilePath(path, "share/cmake_tool/c_library.h.in");
+    m_cLibSourcePath = FileUtils::buildFilePath(path, "share/cmake_tool/c_library.c.in");
 
     bool hasTemplateFiles = FileUtils::fileExists(m_cppMainPath) &&
                             FileUtils::fileExists(m_cppCMakePath) &&
@@ -125,8 +242,32 @@ bool PackageTool::_isValidTemplatePath(const std::string &path)
     g_log << "{" << std::endl;
     g_log << "\tCPP CMakeLists.txt Template Path: " << m_cppCMakePath << std::endl;
     g_log << "\tCPP main.cpp Template Path: " << m_cppMainPath << std::endl;
+    g_log << "\tCPP pch.hpp Template Path: " << m_cppPchPath << std::endl;
+    g_log << "\tCPP modules CMakeLists.txt Template Path: " << m_cppModulesCMakePath << std::endl;
+    g_log << "\tCPP module.cppm Template Path: " << m_cppModulePath << std::endl;
+    g_log << "\tCPP modules main.cpp Template Path: " << m_cppModulesMainPath << std::endl;
+    g_log << "\tCPP modular CMakeLists.txt Template Path: " << m_cppModularCMakePath << std::endl;
+    g_log << "\tCPP modular main.cpp Template Path: " << m_cppModularMainPath << std::endl;
+    g_log << "\tCPP component CMakeLists.txt Template Path: " << m_cppComponentCMakePath << std::endl;
+    g_log << "\tCPP component header Template Path: " << m_cppComponentHeaderPath << std::endl;
+    g_log << "\tCPP component source Template Path: " << m_cppComponentSourcePath << std::endl;
     g_log << "\tC CMakeLists.txt Template Path: " << m_cCMakePath << std::endl;
     g_log << "\tC main.c Template Path: " << m_cMainPath << std::endl;
+    g_log << "\tCPP library CMakeLists.txt Template Path: " << m_cppLibCMakePath << std::endl;
+    g_log << "\tCPP library header Template Path: " << m_cppLibHeaderPath << std::endl;
+    g_log << "\tCPP library source Template Path: " << m_cppLibSourcePath << std::endl;
+    g_log << "\tC library CMakeLists.txt Template Path: " << m_cLibCMakePath << std::endl;
+    g_log << "\tC library header Template Path: " << m_cLibHeaderPath << std::endl;
+    g_log << "\tC library source Template Path: " << m_cLibSourcePath << std::endl;
+    g_log << "\tBuild profile Template Path: " << m_profilePath << std::endl;
+    g_log << "\tRT CMakeLists.txt Template Path: " << m_rtCMakePath << std::endl;
+    g_log << "\tRT rt_support.hpp Template Path: " << m_rtSupportPath << std::endl;
+    g_log << "\tRT main.cpp Template Path: " << m_rtMainPath << std::endl;
+    g_log << "\tTracing trace.hpp Template Path: " << m_tracePath << std::endl;
+    g_log << "\tBenchmark CMakeLists.txt Template Path: " << m_benchCMakePath << std::endl;
+    g_log << "\tBenchmark harness Template Path: " << m_benchHeaderPath << std::endl;
+    g_log << "\tBenchmark main Template Path: " << m_benchMainPath << std::endl;
+    g_log << "\tCustom templates Path: " << m_templatesPath << std::endl;
 
     g_log << "\tHAS CPP APPLICATION FILES: " << (hasTemplateFiles ? "TRUE" : "FALSE") << std::endl;
     g_log << "}" << std::endl;
@@ -151,6 +292,12 @@ bool PackageTool::_isValidPackageType(const PackageType &type)
         return true;
     if (type == PackageType::CMAKE_C_PACKAGE)
         return true;
+    if (type == PackageType::CMAKE_CPP_LIBRARY)
+        return true;
+    if (type == PackageType::CMAKE_C_LIBRARY)
+        return true;
+    if (type == PackageType::CMAKE_CPP_RT_PACKAGE)
+        return true;
     return false;
 }
 
@@ -256,108 +403,344 @@ bool PackageTool::_createDirectory()
 
 void PackageTool::_createCPPProject()
 {
-    std::string incPath;
-    std::string srcPath;
-    std::string mainPath;
-    std::string cmakePath;
     g_log << "_createCPPProject" << std::endl
           << "{" << std::endl;
-    std::string contents = FileUtils::getFileContents(m_cppCMakePath);
-    std::string mainContents = FileUtils::getFileContents(m_cppMainPath);
+    std::string incPath = FileUtils::buildFilePath(m_currentPackage.path, "include/");
+    std::string srcPath = FileUtils::buildFilePath(m_currentPackage.path, "src/");
+    FileUtils::createDirectory(incPath);
+    FileUtils::createDirectory(srcPath);
+    g_log << "\tCreating path at \"" << incPath << "\"" << std::endl;
+    g_log << "\tCreating path at \"" << srcPath << "\"" << std::endl;
 
-    if (contents.size() == 0)
+    // the modules skeleton replaces the header based CMakeLists.txt and main.cpp
+    std::string name = FileUtils::getFileName(m_currentPackage.path);
+    std::vector<std::pair<std::string, std::string>> files = {
+        {m_createOptions.modules ? m_cppModulesCMakePath : m_cppCMakePath, FileUtils::buildFilePath(m_currentPackage.path, "CMakeLists.txt")},
+        {m_createOptions.modules ? m_cppModulesMainPath : m_cppMainPath, FileUtils::buildFilePath(srcPath, name + ".cpp")},
+    };
+    if (m_createOptions.modules)
     {
-        g_log << (EXCEPTION_TAG + "Failed to get any contents from file at \"" + m_cppCMakePath + "\"") << std::endl;
-        g_log.close();
-        throw InvalidOperationException(EXCEPTION_TAG + "Failed to get any contents from file at \"" + m_cppCMakePath + "\"");
+        files.emplace_back(m_cppModulePath, FileUtils::buildFilePath(srcPath, name + ".cppm"));
     }
-
-    if (mainContents.size() == 0)
+    if (m_createOptions.pch)
     {
-        g_log << (EXCEPTION_TAG + "Failed to get any contents from file at \"" + m_cppMainPath + "\"") << std::endl;
-        g_log.close();
-        throw InvalidOperationException(EXCEPTION_TAG + "Failed to get any contents from file at \"" + m_cppMainPath + "\"");
+        files.emplace_back(m_cppPchPath, FileUtils::buildFilePath(incPath, "pch.hpp"));
     }
+    _writeTemplateFiles(files);
+    g_log << "}" << std::endl;
+}
+
+void PackageTool::_createCProject()
+{
+    g_log << "_createCProject" << std::endl
+          << "{" << std::endl;
+    std::string incPath = FileUtils::buildFilePath(m_currentPackage.path, "include/");
+    std::string srcPath = FileUtils::buildFilePath(m_currentPackage.path, "src/");
+    FileUtils::createDirectory(incPath);
+    FileUtils::createDirectory(srcPath);
+    g_log << "\tCreating path at \"" << incPath << "\"" << std::endl;
+    g_log << "\tCreating path at \"" << srcPath << "\"" << std::endl;
 
-    StringUtils::replaceInPlace(contents, "%%PROJECT_NAME%%", FileUtils::getFileName(m_currentPackage.path));
+    _writeTemplateFiles({
+        {m_cCMakePath, FileUtils::buildFilePath(m_currentPackage.path, "CMakeLists.txt")},
+        {m_cMainPath, FileUtils::buildFilePath(srcPath, FileUtils::getFileName(m_currentPackage.path) + ".c")},
+    });
+    g_log << "}" << std::endl;
+}
 
-    incPath = FileUtils::buildFilePath(m_currentPackage.path, "include/");
-    srcPath = FileUtils::buildFilePath(m_currentPackage.path, "src/");
-    cmakePath = FileUtils::buildFilePath(m_currentPackage.path, "CMakeLists.txt");
-    mainPath = FileUtils::buildFilePath(srcPath, FileUtils::getFileName(m_currentPackage.path) + ".cpp");
+void PackageTool::_createLibraryProject()
+{
+    bool cpp = m_currentPackage.type == PackageType::CMAKE_CPP_LIBRARY;
+    const std::string &cmakeTemplatePath = cpp ? m_cppLibCMakePath : m_cLibCMakePath;
+    const std::string &headerTemplatePath = cpp ? m_cppLibHeaderPath : m_cLibHeaderPath;
+    const std::string &sourceTemplatePath = cpp ? m_cppLibSourcePath : m_cLibSourcePath;
+    g_log << "_createLibraryProject" << std::endl
+          << "{" << std::endl;
 
+    std::string name = FileUtils::getFileName(m_currentPackage.path);
+    // the public header lives in include/<name>/, next to the export header generated at build time
+    std::string incPath = FileUtils::buildFilePath(m_currentPackage.path, "include/" + name + "/");
+    std::string srcPath = FileUtils::buildFilePath(m_currentPackage.path, "src/");
     FileUtils::createDirectory(incPath);
     FileUtils::createDirectory(srcPath);
-    FileUtils::writeFileContents(cmakePath, contents);
-    FileUtils::writeFileContents(mainPath, mainContents);
+    g_log << "\tCreating path at \"" << incPath << "\"" << std::endl;
+    g_log << "\tCreating path at \"" << srcPath << "\"" << std::endl;
+
+    std::vector<std::pair<std::string, std::string>> files = {
+        {cmakeTemplatePath, FileUtils::buildFilePath(m_currentPackage.path, "CMakeLists.txt")},
+        {headerTemplatePath, FileUtils::buildFilePath(incPath, name + (cpp ? ".hpp" : ".h"))},
+        {sourceTemplatePath, FileUtils::buildFilePath(srcPath, name + (cpp ? ".cpp" : ".c"))},
+    };
+    if (cpp && m_createOptions.pch)
+    {
+        files.emplace_back(m_cppPchPath, FileUtils::buildFilePath(m_currentPackage.path, "include/pch.hpp"));
+    }
+    _writeTemplateFiles(files);
+    g_log << "}" << std::endl;
+}
 
+void PackageTool::_createRtProject()
+{
+    g_log << "_createRtProject" << std::endl
+          << "{" << std::endl;
+    std::string incPath = FileUtils::buildFilePath(m_currentPackage.path, "include/");
+    std::string srcPath = FileUtils::buildFilePath(m_currentPackage.path, "src/");
+    FileUtils::createDirectory(incPath);
+    FileUtils::createDirectory(srcPath);
     g_log << "\tCreating path at \"" << incPath << "\"" << std::endl;
     g_log << "\tCreating path at \"" << srcPath << "\"" << std::endl;
-    g_log << "\tCreating path at \"" << cmakePath << "\"" << std::endl;
-    g_log << "\tCreating path at \"" << mainPath << "\"" << std::endl
-          << "}" << std::endl;
+
+    std::vector<std::pair<std::string, std::string>> files = {
+        {m_rtCMakePath, FileUtils::buildFilePath(m_currentPackage.path, "CMakeLists.txt")},
+        {m_rtSupportPath, FileUtils::buildFilePath(incPath, "rt_support.hpp")},
+        {m_rtMainPath, FileUtils::buildFilePath(srcPath, FileUtils::getFileName(m_currentPackage.path) + ".cpp")},
+    };
+    if (m_createOptions.pch)
+    {
+        files.emplace_back(m_cppPchPath, FileUtils::buildFilePath(incPath, "pch.hpp"));
+    }
+    _writeTemplateFiles(files);
+    g_log << "}" << std::endl;
 }
 
-void PackageTool::_createCProject()
+void PackageTool::_createModularProject()
 {
-    std::string incPath;
-    std::string srcPath;
-    std::string mainPath;
-    std::string cmakePath;
-    g_log << "_createCProject" << std::endl
+    g_log << "_createModularProject" << std::endl
           << "{" << std::endl;
-    std::string contents = FileUtils::getFileContents(m_cCMakePath);
-    std::string mainContents = FileUtils::getFileContents(m_cMainPath);
+    std::string incPath = FileUtils::buildFilePath(m_currentPackage.path, "include/");
+    std::string srcPath = FileUtils::buildFilePath(m_currentPackage.path, "src/");
+    FileUtils::createDirectory(incPath);
+    FileUtils::createDirectory(srcPath);
+    g_log << "\tCreating path at \"" << incPath << "\"" << std::endl;
+    g_log << "\tCreating path at \"" << srcPath << "\"" << std::endl;
 
-    if (contents.size() == 0)
+    std::vector<std::pair<std::string, std::string>> files = {
+        {m_cppModularCMakePath, FileUtils::buildFilePath(m_currentPackage.path, "CMakeLists.txt")},
+        {m_cppModularMainPath, FileUtils::buildFilePath(srcPath, FileUtils::getFileName(m_currentPackage.path) + ".cpp")},
+    };
+    if (m_createOptions.pch)
     {
-        g_log << (EXCEPTION_TAG + "Failed to get any contents from file at \"" + m_cCMakePath + "\"") << std::endl;
-        g_log.close();
-        throw InvalidOperationException(EXCEPTION_TAG + "Failed to get any contents from file at \"" + m_cCMakePath + "\"");
+        files.emplace_back(m_cppPchPath, FileUtils::buildFilePath(incPath, "pch.hpp"));
     }
+    _writeTemplateFiles(files);
 
-    if (mainContents.size() == 0)
+    // the component list is filled in by the sync at the end of _createProject
+    std::string componentsPath = SourceSync::getComponentsPath(m_currentPackage.path);
+    FileUtils::writeFileContents(componentsPath, "");
+    g_log << "\tCreating path at \"" << componentsPath << "\"" << std::endl;
+    _createComponent("core");
+    g_log << "}" << std::endl;
+}
+
+void PackageTool::_createComponent(const std::string &component_name)
+{
+    std::string componentPath = FileUtils::buildFilePath(m_currentPackage.path, "src/" + component_name + "/");
+    FileUtils::createDirectory(componentPath);
+    g_log << "\tCreating path at \"" << componentPath << "\"" << std::endl;
+
+    std::vector<std::pair<std::string, std::string>> files = {
+        {m_cppComponentCMakePath, FileUtils::buildFilePath(componentPath, "CMakeLists.txt")},
+        {m_cppComponentHeaderPath, FileUtils::buildFilePath(componentPath, component_name + ".hpp")},
+        {m_cppComponentSourcePath, FileUtils::buildFilePath(componentPath, component_name + ".cpp")},
+    };
+    _writeTemplateFiles(files, {{"COMPONENT_NAME", component_name}});
+}
+
+void PackageTool::_writeTemplateFiles(const std::vector<std::pair<std::string, std::string>> &files,
+                                      const TemplateEngine::Variables &variables)
+{
+    TemplateEngine::Variables allVariables = _getTemplateVariables();
+    for (const auto &variable : variables)
     {
-        g_log << (EXCEPTION_TAG + "Failed to get any contents from file at \"" + m_cMainPath + "\"") << std::endl;
-        g_log.close();
-        throw InvalidOperationException(EXCEPTION_TAG + "Failed to get any contents from file at \"" + m_cMainPath + "\"");
+        allVariables[variable.first] = variable.second;
     }
 
-    StringUtils::replaceInPlace(contents, "%%PROJECT_NAME%%", FileUtils::getFileName(m_currentPackage.path));
+    std::string contents;
+    for (const auto &file : files)
+    {
+        // parsed once per template, also when several packages are created
+        const TemplateEngine::Template *parsed = m_templateEngine.load(file.first);
+        if (parsed == nullptr)
+        {
+            g_log << (EXCEPTION_TAG + "Failed to get any contents from file at \"" + file.first + "\"") << std::endl;
+            g_log.close();
+            throw InvalidOperationException(EXCEPTION_TAG + "Failed to get any contents from file at \"" + file.first + "\"");
+        }
+        parsed->render(allVariables, contents);
+        FileUtils::writeFileContents(file.second, contents);
+        g_log << "\tCreating path at \"" << file.second << "\"" << std::endl;
+    }
+}
 
-    incPath = FileUtils::buildFilePath(m_currentPackage.path, "include/");
-    srcPath = FileUtils::buildFilePath(m_currentPackage.path, "src/");
-    cmakePath = FileUtils::buildFilePath(m_currentPackage.path, "CMakeLists.txt");
-    mainPath = FileUtils::buildFilePath(srcPath, FileUtils::getFileName(m_currentPackage.path) + ".c");
+TemplateEngine::Variables PackageTool::_getTemplateVariables()
+{
+    std::string name = FileUtils::getFileName(m_currentPackage.path);
+    TemplateEngine::Variables variables;
+    variables["PROJECT_NAME"] = name;
+    variables["UNITY_BUILD"] = m_createOptions.unity_batch_size > 0 ? "ON" : "OFF";
+    variables["UNITY_BATCH_SIZE"] = std::to_string(m_createOptions.unity_batch_size > 0 ? m_createOptions.unity_batch_size : 8);
+    variables["PCH"] = m_createOptions.pch ? "ON" : "OFF";
+    variables["PROFILE"] = m_createOptions.profile.empty() ? "none" : m_createOptions.profile;
+
+    // module names, namespaces and macros are identifiers, e.g. package "net-utils" exports module "net_utils"
+    std::string identifier = name;
+    for (char &c : identifier)
+    {
+        c = isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    if (identifier.empty() || isdigit(static_cast<unsigned char>(identifier[0])))
+    {
+        identifier = "m_" + identifier;
+    }
+    std::string identifier_upper = identifier;
+    for (char &c : identifier_upper)
+    {
+        c = toupper(static_cast<unsigned char>(c));
+    }
+    variables["MODULE_NAME"] = identifier;
+    variables["IDENTIFIER"] = identifier;
+    variables["IDENTIFIER_UPPER"] = identifier_upper;
+
+    // the standard of the language of the package, C++20 at least for named modules
+    bool c_package = m_currentPackage.type == PackageType::CMAKE_C_PACKAGE || m_currentPackage.type == PackageType::CMAKE_C_LIBRARY;
+    variables["CXX_STANDARD"] = !c_package && !m_createOptions.standard.empty() ? m_createOptions.standard : (m_createOptions.modules ? "20" : "11");
+    variables["C_STANDARD"] = c_package && !m_createOptions.standard.empty() ? m_createOptions.standard : "99";
+
+    // for the header comments of custom templates
+    std::string author = SystemUtils::getEnv("CMAKE_TOOL_AUTHOR");
+    variables["AUTHOR"] = author.empty() ? SystemUtils::getUserName() : author;
+    char date[16] = "";
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%d", localtime(&now));
+    variables["DATE"] = date;
+    variables["YEAR"] = std::string(date, 4);
+    return variables;
+}
 
-    FileUtils::createDirectory(incPath);
-    FileUtils::createDirectory(srcPath);
-    FileUtils::writeFileContents(cmakePath, contents);
-    FileUtils::writeFileContents(mainPath, mainContents);
+std::string PackageTool::_getTemplateDir()
+{
+    // a directory, else a name of share/cmake_tool/templates/
+    const std::string &templateDir = m_createOptions.template_dir;
+    if (FileUtils::isDirectory(templateDir))
+    {
+        return FileUtils::getAbsolutePath(templateDir);
+    }
+    std::string namedDir = FileUtils::buildFilePath(m_templatesPath, templateDir);
+    return FileUtils::isDirectory(namedDir) ? namedDir : "";
+}
 
-    g_log << "\tCreating path at \"" << incPath << "\"" << std::endl;
-    g_log << "\tCreating path at \"" << srcPath << "\"" << std::endl;
-    g_log << "\tCreating path at \"" << cmakePath << "\"" << std::endl;
-    g_log << "\tCreating path at \"" << mainPath << "\"" << std::endl
-          << "}" << std::endl;
+void PackageTool::_createTemplateProject()
+{
+    std::string templateDir = _getTemplateDir();
+    g_log << "_createTemplateProject: " << templateDir << std::endl
+          << "{" << std::endl;
+    for (const std::string &path : m_templateEngine.renderTree(templateDir, m_currentPackage.path, _getTemplateVariables()))
+    {
+        g_log << "\tCreating path at \"" << path << "\"" << std::endl;
+    }
+    g_log << "}" << std::endl;
 }
 
 void PackageTool::_createProject()
 {
-    switch (m_currentPackage.type)
+    if (!m_createOptions.template_dir.empty())
     {
-    case PackageType::CMAKE_CPP_PACKAGE:
-        _createCPPProject();
-        break;
+        _createTemplateProject();
+    }
+    else
+    {
+        switch (m_currentPackage.type)
+        {
+        case PackageType::CMAKE_CPP_PACKAGE:
+            if (m_createOptions.modular)
+            {
+                _createModularProject();
+            }
+            else
+            {
+                _createCPPProject();
+            }
+            break;
 
-    case PackageType::CMAKE_C_PACKAGE:
-        _createCProject();
-        break;
+        case PackageType::CMAKE_C_PACKAGE:
+            _createCProject();
+            break;
 
-    default:
-        throw InvalidOperationException("Invalid type was detected for cmake_tool.");
-        break;
+        case PackageType::CMAKE_CPP_LIBRARY:
+        case PackageType::CMAKE_C_LIBRARY:
+            _createLibraryProject();
+            break;
+
+        case PackageType::CMAKE_CPP_RT_PACKAGE:
+            _createRtProject();
+            break;
+
+        default:
+            throw InvalidOperationException("Invalid type was detected for cmake_tool.");
+            break;
+        }
+    }
+    // a custom template may bring its own profile
+    if (!FileUtils::fileExists(FileUtils::buildFilePath(m_currentPackage.path, "cmake_tool_profile.cmake")))
+    {
+        _createProfileFile();
+    }
+    if (m_createOptions.tracing)
+    {
+        _createTraceFile();
+    }
+    if (m_createOptions.bench)
+    {
+        _createBenchFiles();
+    }
+    SourceSync::sync(m_currentPackage.path);
+}
+
+void PackageTool::_createProfileFile()
+{
+    g_log << "_createProfileFile" << std::endl
+          << "{" << std::endl;
+    _writeTemplateFiles({{m_profilePath, FileUtils::buildFilePath(m_currentPackage.path, "cmake_tool_profile.cmake")}});
+    g_log << "}" << std::endl;
+}
+
+void PackageTool::_createBenchFiles()
+{
+    g_log << "_createBenchFiles" << std::endl
+          << "{" << std::endl;
+    std::string benchPath = FileUtils::buildFilePath(m_currentPackage.path, "bench/");
+    FileUtils::createDirectory(benchPath);
+    g_log << "\tCreating path at \"" << benchPath << "\"" << std::endl;
+
+    std::vector<std::pair<std::string, std::string>> files = {
+        {m_benchCMakePath, FileUtils::buildFilePath(benchPath, "CMakeLists.txt")},
+        {m_benchHeaderPath, FileUtils::buildFilePath(benchPath, "bench.hpp")},
+        {m_benchMainPath, FileUtils::buildFilePath(benchPath, FileUtils::getFileName(m_currentPackage.path) + "_bench.cpp")},
+    };
+    _writeTemplateFiles(files);
+    g_log << "}" << std::endl;
+}
+
+void PackageTool::_createTraceFile()
+{
+    g_log << "_createTraceFile" << std::endl
+          << "{" << std::endl;
+    std::string incPath = FileUtils::buildFilePath(m_currentPackage.path, "include/");
+    FileUtils::createDirectory(incPath);
+    _writeTemplateFiles({{m_tracePath, FileUtils::buildFilePath(incPath, "trace.hpp")}});
+    g_log << "}" << std::endl;
+}
+
+bool PackageTool::isValidProfile(const std::string &profile)
+{
+    for (const char *name : {"none", "debug", "release", "native", "lto", "fastbuild"})
+    {
+        if (profile == name)
+        {
+            return true;
+        }
     }
+    return false;
 }
 
 bool PackageTool::_deleteDirectory()
@@ -381,10 +764,10 @@ bool PackageTool::_deleteDirectory()
 
 bool PackageTool::_cleanInstallFiles()
 {
-    std::string cache_path = FileUtils::buildFilePath(m_currentPackage.path, "build/");
+    std::string cache_path = m_buildRoot.getBuildPath(m_currentPackage.path);
     if (FileUtils::fileExists(cache_path))
     {
-        std::string cmd = ("cd " + cache_path + " && make clean 2> /dev/null || true && (cat install_manifest.txt; echo) | sh -c 'while read line; do echo \"    rm -f $line\"; rm -f \"$line\"; rmdir --ignore-fail-on-non-empty -p \"${line%/*}\" 2> /dev/null || true; done' && cd - > /dev/null 2>&1;") + ("echo \"    rm -rf \"" + cache_path + " && rm -rf " + cache_path);
+        std::string cmd = ("cd " + cache_path + " && make clean 2> /dev/null || true && (find . -name install_manifest.txt -exec sh -c 'cat \"$1\" && echo' sh {} \\;) | sh -c 'while read line; do [ -z \"$line\" ] && continue; echo \"    rm -f $line\"; rm -f \"$line\"; rmdir --ignore-fail-on-non-empty -p \"${line%/*}\" 2> /dev/null || true; done' && cd - > /dev/null 2>&1;") + ("echo \"    rm -rf \"" + cache_path + " && rm -rf " + cache_path);
         pid_t status = system(cmd.c_str());
         if (0 != WEXITSTATUS(status))
         {
@@ -430,6 +813,22 @@ void PackageTool::_getAllPackagePaths(std::vector<std::string> &output_paths)
     g_create_info.close();
 }
 
+std::string PackageTool::_getBuildInputs()
+{
+    // everything outside the package tree that changes the installed files
+    std::string build_inputs = "cmake_tool-build-v1";
+    struct utsname system_name;
+    if (uname(&system_name) == 0)
+    {
+        build_inputs = build_inputs + ";" + system_name.sysname + ";" + system_name.machine;
+    }
+    for (const char *env : {"CC", "CXX", "CFLAGS", "CXXFLAGS", "LDFLAGS", "CMAKE_PREFIX_PATH"})
+    {
+        build_inputs = build_inputs + ";" + env + "=" + SystemUtils::getEnv(env);
+    }
+    return build_inputs;
+}
+
 void PackageTool::_createPackage(const std::string &package_path, PackageType package_type, bool quiet)
 {
     if (StringUtils::trimmed(package_path).empty())
@@ -439,6 +838,13 @@ void PackageTool::_createPackage(const std::string &package_path, PackageType pa
         return;
     }
 
+    if (!m_createOptions.template_dir.empty() && _getTemplateDir().empty())
+    {
+        std::cerr << "Error: template \"" << m_createOptions.template_dir << "\" is neither a directory nor a template of \"" << m_templatesPath << "\"" << std::endl;
+        g_log << "Error: template \"" << m_createOptions.template_dir << "\" not found" << std::endl;
+        return;
+    }
+
     _updateCurrentPackage(package_path, package_type);
 
     if (_createDirectory())
@@ -465,6 +871,18 @@ void PackageTool::createPackage(const std::string &package_path, const std::stri
     {
         type = PackageType::CMAKE_C_PACKAGE;
     }
+    else if (StringUtils::equals(package_type, "LIB"))
+    {
+        type = PackageType::CMAKE_CPP_LIBRARY;
+    }
+    else if (StringUtils::equals(package_type, "CLIB"))
+    {
+        type = PackageType::CMAKE_C_LIBRARY;
+    }
+    else if (StringUtils::equals(package_type, "RT"))
+    {
+        type = PackageType::CMAKE_CPP_RT_PACKAGE;
+    }
 
     if (!_isValidPackageType(type))
     {
@@ -549,15 +967,8 @@ void PackageTool::listPackages(bool basename_only, bool path_only)
     g_log << "<<-- end cmake_tool list" << std::endl;
 }
 
-void PackageTool::_buildPackage(const std::string &package_path, bool quiet)
+void PackageTool::_showStats(const std::vector<std::string> &package_paths, const std::string &sort_key, bool show_stages)
 {
-    if (StringUtils::trimmed(package_path).empty())
-    {
-        std::cerr << (EXCEPTION_TAG + "No name was specified for this project!") << std::endl;
-        g_log << (EXCEPTION_TAG + "No name was specified for this project!") << std::endl;
-        return;
-    }
-
     if (m_createInfoPath.empty())
     {
         std::cerr << "Error: share path not find!" << std::endl;
@@ -565,112 +976,1024 @@ void PackageTool::_buildPackage(const std::string &package_path, bool quiet)
         return;
     }
 
-    _updateCurrentPackage(package_path);
+    std::map<std::string, std::function<double(const BuildRecord &)>> sort_values = {
+        {"cpu", [](const BuildRecord &record) { return record.getUsage().user_seconds + record.getUsage().system_seconds; }},
+        {"rss", [](const BuildRecord &record) { return static_cast<double>(record.getUsage().max_rss_kb); }},
+        {"time", [](const BuildRecord &record) { return record.getSeconds(); }},
+        {"io", [](const BuildRecord &record) { return static_cast<double>(record.getUsage().block_input + record.getUsage().block_output); }},
+    };
+    auto sort_value = sort_values.find(sort_key.empty() ? "cpu" : sort_key);
+    if (sort_value == sort_values.end())
+    {
+        std::cerr << "Error: unknown sort key [" << sort_key << "], expected cpu, rss, time or io." << std::endl;
+        g_log << "Error: unknown sort key [" << sort_key << "]" << std::endl;
+        return;
+    }
 
-    std::string line;
-    bool package_find = false;
-    std::vector<std::string> match_basename_paths;
+    std::vector<std::string> found_paths;
+    for (const std::string &package_path : package_paths)
+    {
+        _findBuildPackages(package_path, found_paths);
+    }
+    if (!package_paths.empty() && found_paths.empty())
+    {
+        return;
+    }
 
-    g_create_info.open(m_createInfoPath, std::ios::in);
-    while (std::getline(g_create_info, line))
+    BuildStats build_stats;
+    build_stats.load(_getBuildStatsPath());
+    std::vector<BuildRecord> records;
+    for (const BuildRecord &record : build_stats.getRecords())
     {
-        if (line.empty())
+        if (found_paths.empty() || found_paths.end() != std::find(found_paths.begin(), found_paths.end(), record.package_path))
         {
-            continue;
+            records.emplace_back(record);
         }
+    }
+    if (records.empty())
+    {
+        std::cout << "No build stats recorded yet, they are collected by 'cmake_tool build'." << std::endl;
+        return;
+    }
+    std::stable_sort(records.begin(), records.end(), [&](const BuildRecord &a, const BuildRecord &b) {
+        return sort_value->second(a) > sort_value->second(b);
+    });
 
-        StringUtils::trimmedInPlace(line);
-        if (line.front() == '~')
-        {
-            const char *homeDir = getenv("HOME");
-            if (homeDir != nullptr)
-            {
-                line.replace(0, 1, homeDir);
-            }
-        }
+    std::vector<std::string> record_names;
+    int max_first_column_width = 10;
+    for (const BuildRecord &record : records)
+    {
+        record_names.emplace_back(FileUtils::getFileName(record.package_path) + (record.variant.empty() ? "" : " [" + record.variant + "]"));
+        max_first_column_width = std::max<int>(max_first_column_width, record_names.back().length() + 1);
+    }
 
-        if (line == m_currentPackage.path)
-        {
-            // 全路径匹配，直接构建
-            package_find = true;
-            if (FileUtils::fileExists(line))
-            {
-                if (!quiet)
-                {
-                    std::cout << std::endl
-                              << ">> build start: \"" << m_currentPackage.path << "\"" << std::endl;
-                }
-                std::string cache_path = FileUtils::buildFilePath(line, "build/");
-                std::string cmd = ("mkdir " + cache_path + " > /dev/null 2>&1;") + ("cd " + cache_path + " && cmake .. && make && make install && cd - > /dev/null 2>&1");
-                pid_t status = system(cmd.c_str());
-                if (0 != WEXITSTATUS(status))
-                {
-                    std::cerr << "!! build failed: \"" << m_currentPackage.path << "\"" << std::endl;
-                    g_log << "!! build failed: \"" << m_currentPackage.path << "\"" << std::endl;
-                }
-                else
-                {
-                    if (!quiet)
-                    {
-                        std::cout << "<< build success: \"" << m_currentPackage.path << "\"" << std::endl;
-                    }
-                    g_log << "<< build success: \"" << m_currentPackage.path << "\"" << std::endl;
-                }
-                g_create_info.close();
-                return;
-            }
-        }
-        else if (FileUtils::getFileName(line) == package_path)
+    ProcessUsage total_usage;
+    double prefetch_seconds = 0.0;
+    std::cout << "Latest " << records.size() << " build(s), sorted by " << sort_value->first << ":" << std::endl;
+    printf("    %-*s %-8s %-16s %9s %9s %9s %10s %10s %10s %9s\n", max_first_column_width, "package", "status", "built", "wall", "user", "sys",
+           "max rss", "read", "written", "prefetch");
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const BuildRecord &record = records[i];
+        ProcessUsage usage = record.getUsage();
+        total_usage.add(usage);
+
+        char built[32] = "-";
+        time_t build_time = static_cast<time_t>(record.time);
+        struct tm build_tm;
+        if (localtime_r(&build_time, &build_tm) != nullptr)
         {
-            // 路径名不匹配，但包名匹配
-            package_find = true;
-            match_basename_paths.emplace_back(line);
+            strftime(built, sizeof(built), "%Y-%m-%d %H:%M", &build_tm);
         }
-        else
+        printf("    %-*s %-8s %-16s %8.1fs %8.1fs %8.1fs %10s %10s %10s %8.2fs\n", max_first_column_width, record_names[i].c_str(),
+               record.state.c_str(), built, record.getSeconds(), usage.user_seconds, usage.system_seconds,
+               _formatMemory(usage.max_rss_kb).c_str(), _formatMemory(usage.block_input / 2).c_str(), _formatMemory(usage.block_output / 2).c_str(),
+               record.prefetch_seconds);
+        prefetch_seconds += record.prefetch_seconds;
+
+        for (size_t stage = 0; show_stages && stage < 3; ++stage)
         {
-            // 不匹配
+            const ProcessUsage &stage_usage = record.stage_usage[stage];
+            printf("    %-*s %-8s %-16s %8.1fs %8.1fs %8.1fs %10s %10s %10s\n", max_first_column_width, "", "",
+                   BuildScheduler::getStageName(static_cast<BuildStage>(stage)), record.stage_seconds[stage], stage_usage.user_seconds, stage_usage.system_seconds,
+                   _formatMemory(stage_usage.max_rss_kb).c_str(), _formatMemory(stage_usage.block_input / 2).c_str(), _formatMemory(stage_usage.block_output / 2).c_str());
         }
     }
-    g_create_info.close();
+    printf("    %.1fs cpu (%.1fs user, %.1fs sys), peak rss %s, ~%.2fs of cold source reads done by the prefetch\n",
+           total_usage.user_seconds + total_usage.system_seconds, total_usage.user_seconds, total_usage.system_seconds,
+           _formatMemory(total_usage.max_rss_kb).c_str(), prefetch_seconds);
+}
 
-    if (!package_find)
+void PackageTool::showStats(const std::vector<std::string> &package_paths, const std::string &sort_key, bool show_stages)
+{
+    g_log << "-->> run cmake_tool stats: " << StringUtils::join(package_paths, " ") << std::endl;
+    _showStats(package_paths, sort_key, show_stages);
+    g_log << "<<-- end cmake_tool stats" << std::endl;
+}
+
+void PackageTool::setBuildRoot(const std::string &root_dir, std::uint64_t min_free_bytes)
+{
+    m_buildRoot.setRootDirectory(root_dir);
+    m_buildRoot.setMinFreeBytes(min_free_bytes);
+    if (!root_dir.empty())
     {
-        std::cout << "Warning: not find package [" << package_path << "]" << std::endl;
-        g_log << "Warning: not find package [" << package_path << "]" << std::endl;
+        g_log << "build root: \"" << m_buildRoot.getRootDirectory() << "\"" << std::endl;
     }
+}
+
+std::string PackageTool::_getBuildJournalPath()
+{
+    return FileUtils::buildFilePath(FileUtils::getDirPath(m_createInfoPath), "build.journal");
+}
+
+std::string PackageTool::_getBuildStatsPath()
+{
+    return FileUtils::buildFilePath(FileUtils::getDirPath(m_createInfoPath), "build.stats");
+}
+
+std::string PackageTool::_getPgoCachePath(const std::string &package_path, const std::string &variant)
+{
+    // one entry per package and variant, replaced when the sources drift
+    std::string key = HashUtils::sha256(package_path + "\n" + variant).substr(0, 16);
+    return FileUtils::buildFilePath(FileUtils::getDirPath(m_createInfoPath), "pgo/" + FileUtils::getFileName(package_path) + "-" + key);
+}
+
+std::string PackageTool::_getPgoFingerprint(const std::string &package_path, const std::string &variant)
+{
+    // the profiles name the objects by path, a different build tree needs new ones
+    return m_artifactCache.computeFingerprint(package_path, _getBuildInputs() + ";pgo;" + m_buildOptions.pgo_train + ";" +
+                                                                _getVariantBuildPath(package_path, variant));
+}
+
+std::string PackageTool::_getConfigureArgs(const std::string &package_path, const std::string &variant, std::string &environment)
+{
+    std::string cmake_args;
+    environment.clear();
+    const BuildVariant *build_variant = _findBuildVariant(variant);
+    if (build_variant != nullptr)
+    {
+        environment = build_variant->environment.empty() ? "" : build_variant->environment + " ";
+        if (!variant.empty())
+        {
+            // the default variant keeps the package's own install prefix
+            cmake_args = " -DCMAKE_INSTALL_PREFIX=\"" + _getVariantPrefix(package_path, variant) + "\"";
+        }
+        for (const std::string &cmake_arg : build_variant->cmake_args)
+        {
+            cmake_args += " " + cmake_arg;
+        }
+    }
+    std::string prefix_path = _getDependencyPrefixes(package_path, variant);
+    if (!prefix_path.empty())
+    {
+        cmake_args += " -DCMAKE_PREFIX_PATH=\"" + prefix_path + "\"";
+    }
+    for (const std::string &cmake_arg : m_buildOptions.cmake_args)
+    {
+        cmake_args += " " + cmake_arg;
+    }
+    return cmake_args;
+}
+
+std::string PackageTool::_getArtifactFingerprint(const std::string &package_path, const std::string &variant)
+{
+    // the same key for the prefetch, the restore and the store of a build
+    std::string key = package_path + "\n" + variant;
+    auto it = m_artifactFingerprints.find(key);
+    if (it != m_artifactFingerprints.end())
+    {
+        return it->second;
+    }
+    // a dependency cycle ends here
+    m_artifactFingerprints[key] = "";
+
+    std::string environment;
+    std::string cmake_args = _getConfigureArgs(package_path, variant, environment);
+    std::string build_inputs = _getBuildInputs() + ";" + environment + cmake_args;
+    // the prefix path only names the dependencies, their fingerprints stand for what is installed there
+    for (const std::string &dependency : m_packageGraph.getDependencies(package_path))
+    {
+        build_inputs += ";" + _getArtifactFingerprint(dependency, _getInstalledVariant(variant));
+    }
+    // a profile guided build depends on what the training run recorded, not only on the sources
+    if (cmake_args.find("-DCMAKE_TOOL_PGO=use") != std::string::npos)
+    {
+        std::string profile_path = FileUtils::buildFilePath(_getVariantBuildPath(package_path, variant), "pgo");
+        build_inputs += ";pgo;" + m_artifactCache.computeFingerprint(profile_path, m_buildOptions.pgo_train);
+    }
+    std::string fingerprint = m_artifactCache.computeFingerprint(package_path, build_inputs);
+    m_artifactFingerprints[key] = fingerprint;
+    return fingerprint;
+}
+
+void PackageTool::_prefetchArtifacts(const std::vector<std::string> &package_paths, const std::vector<std::string> &variants)
+{
+    if (m_buildOptions.use_cache && !m_artifactCache.getRemoteUrl().empty())
+    {
+        // download the artifacts of all packages and variants in parallel before building in order
+        std::vector<std::string> fingerprints;
+        for (const std::string &package_path : package_paths)
+        {
+            for (const std::string &variant : variants)
+            {
+                fingerprints.emplace_back(_getArtifactFingerprint(package_path, variant));
+            }
+        }
+        std::cout << "Fetching cached artifacts from \"" << m_artifactCache.getRemoteUrl() << "\" ..." << std::endl;
+        m_artifactCache.prefetch(fingerprints);
+    }
+}
+
+void PackageTool::_findBuildPackages(const std::string &package_path, std::vector<std::string> &output_paths)
+{
+    if (StringUtils::trimmed(package_path).empty())
+    {
+        std::cerr << (EXCEPTION_TAG + "No name was specified for this project!") << std::endl;
+        g_log << (EXCEPTION_TAG + "No name was specified for this project!") << std::endl;
+        return;
+    }
+
+    if (m_createInfoPath.empty())
+    {
+        std::cerr << "Error: share path not find!" << std::endl;
+        g_log << "Error: share path not find!" << std::endl;
+        return;
+    }
+
+    _updateCurrentPackage(package_path);
+
+    std::string line;
+    bool package_find = false;
+    std::vector<std::string> match_basename_paths;
+
+    g_create_info.open(m_createInfoPath, std::ios::in);
+    while (std::getline(g_create_info, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        StringUtils::trimmedInPlace(line);
+        if (line.front() == '~')
+        {
+            const char *homeDir = getenv("HOME");
+            if (homeDir != nullptr)
+            {
+                line.replace(0, 1, homeDir);
+            }
+        }
+
+        if (line == m_currentPackage.path)
+        {
+            // 全路径匹配，直接构建
+            package_find = true;
+            if (FileUtils::fileExists(line))
+            {
+                if (output_paths.end() == std::find(output_paths.begin(), output_paths.end(), line))
+                {
+                    output_paths.emplace_back(line);
+                }
+                g_create_info.close();
+                return;
+            }
+        }
+        else if (FileUtils::getFileName(line) == package_path)
+        {
+            // 路径名不匹配，但包名匹配
+            package_find = true;
+            match_basename_paths.emplace_back(line);
+        }
+        else
+        {
+            // 不匹配
+        }
+    }
+    g_create_info.close();
+
+    if (!package_find)
+    {
+        std::cout << "Warning: not find package [" << package_path << "]" << std::endl;
+        g_log << "Warning: not find package [" << package_path << "]" << std::endl;
+    }
+
+    size_t match_basename_count = match_basename_paths.size();
+    if (match_basename_count == 1)
+    {
+        _findBuildPackages(match_basename_paths[0], output_paths);
+    }
+    else if (match_basename_count > 1)
+    {
+        if (m_force)
+        {
+            for (const auto &path : match_basename_paths)
+            {
+                _findBuildPackages(path, output_paths);
+            }
+        }
+        else
+        {
+            std::cout << "find " << match_basename_count << " packages named \"" << package_path << "\":" << std::endl;
+            for (const auto &path : match_basename_paths)
+            {
+                std::cout << "    " << path << std::endl;
+            }
+            std::cout << "please execute build with full package path, or add option \"-f\" to build all." << std::endl;
+        }
+    }
+}
+
+size_t PackageTool::_getCompileJobs()
+{
+    size_t jobs = m_buildOptions.jobs > 0 ? m_buildOptions.jobs : SystemUtils::getNumCPUThreads();
+    size_t build_jobs = m_buildOptions.build_jobs > 0 ? m_buildOptions.build_jobs : 1;
+    // concurrent compiles share the job budget
+    return std::max<size_t>(1, jobs / build_jobs);
+}
+
+const BuildVariant *PackageTool::_findBuildVariant(const std::string &variant) const
+{
+    for (const BuildVariant &build_variant : m_buildOptions.variants)
+    {
+        if (build_variant.name == variant)
+        {
+            return &build_variant;
+        }
+    }
+    return nullptr;
+}
+
+std::string PackageTool::_getVariantBuildPath(const std::string &package_path, const std::string &variant)
+{
+    std::string build_path = m_buildRoot.getBuildPath(package_path);
+    return variant.empty() ? build_path : FileUtils::buildFilePath(build_path, variant + "/");
+}
+
+std::string PackageTool::_getVariantPrefix(const std::string &package_path, const std::string &variant)
+{
+    return variant.empty() ? package_path : FileUtils::buildFilePath(package_path, "install/" + variant);
+}
+
+std::string PackageTool::_getProgramPath(const std::string &package_path, const std::string &program_name, const std::string &variant)
+{
+    return FileUtils::buildFilePath(_getVariantPrefix(package_path, variant), "bin/" + program_name);
+}
+
+std::string PackageTool::_getJobTitle(const BuildJob &job)
+{
+    return "\"" + job.package_path + "\"" + (job.variant.empty() ? "" : " [" + job.variant + "]");
+}
+
+std::string PackageTool::_getPackageGenerator(const std::string &package_path)
+{
+    if (!m_buildOptions.generator.empty())
+    {
+        return m_buildOptions.generator;
+    }
+    // only Ninja scans C++20 modules, unless the user picked a generator through the environment
+    if (SystemUtils::getEnv("CMAKE_GENERATOR").empty() &&
+        FileUtils::getFileContents(FileUtils::buildFilePath(package_path, "CMakeLists.txt")).find("CXX_MODULES") != std::string::npos)
+    {
+        return "Ninja";
+    }
+    return "";
+}
+
+std::string PackageTool::_getDependencyPrefixes(const std::string &package_path, const std::string &variant)
+{
+    // the install prefixes of the registered packages it find_package()s, e.g. the <Name>Config.cmake of libraries
+    std::string prefixes;
+    if (m_packageGraph.contains(package_path))
+    {
+        for (const std::string &dependency : m_packageGraph.getDependencies(package_path))
+        {
+            prefixes += (prefixes.empty() ? "" : ";") + _getVariantPrefix(dependency, _getInstalledVariant(variant));
+        }
+    }
+    return prefixes;
+}
+
+BuildStageResult PackageTool::_runBuildStage(BuildJob &job, BuildStage stage, bool quiet, bool redirect_output)
+{
+    std::string stage_name = BuildScheduler::getStageName(stage);
+    std::string log_path = redirect_output ? FileUtils::buildFilePath(job.build_path, "cmake_tool_" + stage_name + ".log") : "";
+    std::string cmd;
+
+    switch (stage)
+    {
+    case BuildStage::CONFIGURE:
+        {
+            std::lock_guard<std::mutex> lock(g_output_mutex);
+            if (!quiet)
+            {
+                std::cout << std::endl
+                          << ">> build start: " << _getJobTitle(job) << std::endl;
+            }
+            g_log << ">> build start: " << _getJobTitle(job) << std::endl;
+        }
+        {
+            std::string environment;
+            std::string cmake_args = _getConfigureArgs(job.package_path, job.variant, environment);
+
+            if (m_buildOptions.use_cache)
+            {
+                job.fingerprint = _getArtifactFingerprint(job.package_path, job.variant);
+                if (m_artifactCache.restore(job.fingerprint, job.package_path, job.build_path))
+                {
+                    std::lock_guard<std::mutex> lock(g_output_mutex);
+                    if (!quiet)
+                    {
+                        std::cout << "<< build success (cached " << job.fingerprint.substr(0, 12) << "): " << _getJobTitle(job) << std::endl;
+                    }
+                    g_log << "<< build success (cached " << job.fingerprint << "): " << _getJobTitle(job) << std::endl;
+                    return BuildStageResult::CACHED;
+                }
+            }
+            // the generator of an existing build tree can not change
+            std::string generator = _getPackageGenerator(job.package_path);
+            if (!generator.empty() && !FileUtils::fileExists(FileUtils::buildFilePath(job.build_path, "CMakeCache.txt")))
+            {
+                cmake_args += " -G \"" + generator + "\"";
+            }
+            // the PGO stage is cached in the build tree, only 'build --pgo' sets it
+            if (cmake_args.find("-DCMAKE_TOOL_PGO=") == std::string::npos)
+            {
+                cmake_args += " -UCMAKE_TOOL_PGO";
+            }
+            FileUtils::createDirectory(job.build_path);
+            m_buildRoot.markUsed(job.package_path);
+            cmd = "cd \"" + job.build_path + "\" && " + environment + "cmake" + cmake_args + " \"" + job.package_path + "\"";
+        }
+        break;
+
+    case BuildStage::BUILD:
+        // through cmake, so build trees configured for Ninja (CMAKE_GENERATOR) build as well
+        cmd = "cd \"" + job.build_path + "\" && cmake --build . -j " + std::to_string(_getCompileJobs());
+        break;
+
+    case BuildStage::INSTALL:
+        {
+            const BuildVariant *build_variant = _findBuildVariant(job.variant);
+            if (build_variant != nullptr && !build_variant->install)
+            {
+                std::lock_guard<std::mutex> lock(g_output_mutex);
+                if (!quiet)
+                {
+                    std::cout << "<< build success (not installed): " << _getJobTitle(job) << std::endl;
+                }
+                g_log << "<< build success (not installed): " << _getJobTitle(job) << std::endl;
+                return BuildStageResult::SUCCEEDED;
+            }
+        }
+        cmd = "cd \"" + job.build_path + "\" && cmake --build . --target install";
+        break;
+    }
+
+    if (!log_path.empty())
+    {
+        FileUtils::writeFileContents(log_path, "");
+    }
+
+    bool success = false;
+    if (stage == BuildStage::INSTALL && m_buildOptions.native_install)
+    {
+        NativeInstaller installer(job.build_path);
+        success = installer.install(log_path, &job.stage_usage[static_cast<size_t>(stage)]);
+    }
+    else
+    {
+        success = 0 == SystemUtils::executeShell(cmd, log_path, &job.stage_usage[static_cast<size_t>(stage)]);
+    }
+
+    if (!success)
+    {
+        std::lock_guard<std::mutex> lock(g_output_mutex);
+        std::cerr << "!! build failed: " << _getJobTitle(job) << " (" << stage_name << ")" << std::endl;
+        g_log << "!! build failed: " << _getJobTitle(job) << " (" << stage_name << ")" << std::endl;
+        if (!log_path.empty())
+        {
+            std::vector<std::string> log_lines = FileUtils::getFileLines(log_path);
+            size_t first_line = log_lines.size() > 20 ? log_lines.size() - 20 : 0;
+            for (size_t i = first_line; i < log_lines.size(); ++i)
+            {
+                std::cerr << "    " << log_lines[i] << std::endl;
+            }
+            std::cerr << "    (full log: " << log_path << ")" << std::endl;
+        }
+        return BuildStageResult::FAILED;
+    }
+
+    if (stage == BuildStage::INSTALL)
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_output_mutex);
+            if (!quiet)
+            {
+                std::cout << "<< build success: " << _getJobTitle(job) << std::endl;
+            }
+            g_log << "<< build success: " << _getJobTitle(job) << std::endl;
+        }
+        // packing and hashing the artifact must not hold up the output of the other jobs
+        if (m_buildOptions.use_cache &&
+            m_artifactCache.store(job.fingerprint, job.package_path, FileUtils::buildFilePath(job.build_path, "install_manifest.txt")))
+        {
+            std::lock_guard<std::mutex> lock(g_output_mutex);
+            g_log << "   cached artifact " << job.fingerprint << " at \"" << m_artifactCache.getCacheDirectory() << "\"" << std::endl;
+        }
+    }
+    return BuildStageResult::SUCCEEDED;
+}
+
+void PackageTool::_printBuildSummary(const std::vector<BuildJob> &jobs, double total_seconds)
+{
+    std::vector<std::string> job_names;
+    int max_first_column_width = 8;
+    for (const BuildJob &job : jobs)
+    {
+        job_names.emplace_back(FileUtils::getFileName(job.package_path) + (job.variant.empty() ? "" : " [" + job.variant + "]"));
+        int first_column_width = job_names.back().length() + 1;
+        if (first_column_width > max_first_column_width)
+        {
+            max_first_column_width = first_column_width;
+        }
+    }
+
+    size_t failed_count = 0;
+    double total_cpu_seconds = 0.0;
+    std::cout << std::endl
+              << "Build summary:" << std::endl;
+    printf("    %-*s %-8s %10s %10s %10s %10s %10s\n", max_first_column_width, "package", "status", "configure", "build", "install", "cpu", "max rss");
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const BuildJob &job = jobs[i];
+        ProcessUsage usage;
+        for (const ProcessUsage &stage_usage : job.stage_usage)
+        {
+            usage.add(stage_usage);
+        }
+        total_cpu_seconds += usage.user_seconds + usage.system_seconds;
+        printf("    %-*s %-8s %9.1fs %9.1fs %9.1fs %9.1fs %10s\n", max_first_column_width, job_names[i].c_str(),
+               BuildScheduler::getStateName(job.state), job.stage_seconds[0], job.stage_seconds[1], job.stage_seconds[2],
+               usage.user_seconds + usage.system_seconds, _formatMemory(usage.max_rss_kb).c_str());
+        if (job.state != BuildJobState::SUCCEEDED && job.state != BuildJobState::CACHED)
+        {
+            ++failed_count;
+        }
+    }
+    printf("    %zu builds, %zu not built, %.1fs, %.1fs cpu\n", jobs.size(), failed_count, total_seconds, total_cpu_seconds);
+}
+
+std::vector<BuildJob> PackageTool::_buildPackages(const std::vector<std::string> &package_paths, bool quiet)
+{
+    if (package_paths.empty())
+    {
+        return std::vector<BuildJob>();
+    }
+
+    PackageGraph graph;
+    for (const std::string &package_path : package_paths)
+    {
+        graph.addPackage(package_path);
+    }
+    graph.resolve();
+    std::vector<std::string> sorted_paths = graph.sort(package_paths);
+
+    // dependencies outside this build are found through their install prefix as well
+    std::vector<std::string> registered_paths;
+    if (!m_createInfoPath.empty())
+    {
+        _getAllPackagePaths(registered_paths);
+    }
+    m_packageGraph = PackageGraph();
+    for (const std::string &package_path : registered_paths)
+    {
+        m_packageGraph.addPackage(package_path);
+    }
+    for (const std::string &package_path : package_paths)
+    {
+        m_packageGraph.addPackage(package_path);
+    }
+    m_packageGraph.resolve();
+
+    // explicit source lists must be current before CMake decides whether to reconfigure
+    for (const std::string &package_path : sorted_paths)
+    {
+        _syncPackageSources(package_path, true);
+    }
+
+    if (!m_buildOptions.profile.empty())
+    {
+        for (const std::string &package_path : sorted_paths)
+        {
+            std::string cmake_path = FileUtils::buildFilePath(package_path, "CMakeLists.txt");
+            if (FileUtils::getFileContents(cmake_path).find("cmake_tool_profile.cmake") == std::string::npos)
+            {
+                std::cerr << "Warning: \"" << cmake_path << "\" does not include cmake_tool_profile.cmake, profile '"
+                          << m_buildOptions.profile << "' has no effect on it" << std::endl;
+                g_log << "Warning: \"" << cmake_path << "\" does not include cmake_tool_profile.cmake" << std::endl;
+            }
+        }
+    }
+
+    std::vector<std::string> variants;
+    for (const BuildVariant &build_variant : m_buildOptions.variants)
+    {
+        variants.emplace_back(build_variant.name);
+    }
+    if (variants.empty())
+    {
+        variants.emplace_back("");
+    }
+    // after the source sync and the dependency prefixes, both are part of the fingerprints;
+    // all of them are computed before the workers start, the build stages only look them up
+    m_artifactFingerprints.clear();
+    if (m_buildOptions.use_cache)
+    {
+        for (const std::string &package_path : sorted_paths)
+        {
+            for (const std::string &variant : variants)
+            {
+                _getArtifactFingerprint(package_path, variant);
+            }
+        }
+    }
+    _prefetchArtifacts(sorted_paths, variants);
+
+    // one job per package and variant, a variant only depends on the same variant of other packages
+    BuildScheduler scheduler(m_buildOptions.configure_jobs, m_buildOptions.build_jobs);
+    std::map<std::string, size_t> job_indexes;
+    for (const std::string &package_path : sorted_paths)
+    {
+        for (const std::string &variant : variants)
+        {
+            size_t index = scheduler.addJob(package_path, _getVariantBuildPath(package_path, variant), variant);
+            for (const std::string &dependency : graph.getDependencies(package_path))
+            {
+                // only earlier jobs, a dependency cycle must not stall the pipeline
+                auto it = job_indexes.find(dependency + "\n" + _getInstalledVariant(variant));
+                if (it != job_indexes.end())
+                {
+                    scheduler.addDependency(index, it->second);
+                }
+            }
+            job_indexes[package_path + "\n" + variant] = index;
+        }
+    }
+
+    // several builds run side by side, keep their output in per-stage logs
+    bool redirect_output = scheduler.getJobs().size() > 1;
+    if (redirect_output)
+    {
+        std::cout << "Pipeline: " << m_buildOptions.configure_jobs << " configure, " << m_buildOptions.build_jobs
+                  << " build (-j" << _getCompileJobs() << "), 1 install job(s)" << std::endl;
+    }
+
+    // background builds give way to other work on the machine
+    bool held_back = false;
+    if (m_buildOptions.priority == BuildPriorityClass::BACKGROUND)
+    {
+        scheduler.setAdmissionCheck([&, this]() {
+            double cpu_pressure = 0.0, io_pressure = 0.0;
+            BuildPriority::readPressure("cpu", cpu_pressure);
+            BuildPriority::readPressure("io", io_pressure);
+            bool admit = cpu_pressure <= m_buildOptions.max_pressure && io_pressure <= m_buildOptions.max_pressure;
+            if (admit == held_back)
+            {
+                std::lock_guard<std::mutex> lock(g_output_mutex);
+                char message[128];
+                snprintf(message, sizeof(message), "%s new builds: cpu pressure %.1f%%, io pressure %.1f%%, limit %.1f%%",
+                         admit ? "Resuming" : "Holding back", cpu_pressure, io_pressure, m_buildOptions.max_pressure);
+                if (!quiet)
+                {
+                    std::cout << message << std::endl;
+                }
+                g_log << message << std::endl;
+                held_back = !admit;
+            }
+            return admit;
+        });
+    }
+
+    // make room on the build root volume, never evicting the trees of this build (a tree holds all its variants)
+    std::set<std::string> keep_build_paths;
+    for (const BuildJob &job : scheduler.getJobs())
+    {
+        keep_build_paths.insert(m_buildRoot.getBuildPath(job.package_path));
+    }
+    m_buildRoot.evict(keep_build_paths);
+
+    if (m_buildJournal.isOpen())
+    {
+        m_buildJournal.addPackages(sorted_paths);
+    }
+
+    // a package is done in the journal once all of its variants are
+    std::mutex journal_mutex;
+    std::map<std::string, size_t> remaining_variants;
+    for (const std::string &package_path : sorted_paths)
+    {
+        remaining_variants[package_path] = variants.size();
+    }
+
+    SourcePrefetcher prefetcher;
+    if (m_buildOptions.prefetch)
+    {
+        for (const std::string &package_path : sorted_paths)
+        {
+            prefetcher.addPackage(package_path);
+        }
+        prefetcher.start();
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    scheduler.run([&, this](BuildJob &job, BuildStage stage) {
+        BuildStageResult result = _runBuildStage(job, stage, quiet, redirect_output);
+        if (m_buildJournal.isOpen())
+        {
+            std::lock_guard<std::mutex> lock(journal_mutex);
+            if (result == BuildStageResult::FAILED)
+            {
+                m_buildJournal.setState(job.package_path, BuildJobState::FAILED);
+                remaining_variants[job.package_path] = 0;
+            }
+            else if ((result == BuildStageResult::CACHED || stage == BuildStage::INSTALL) &&
+                     remaining_variants[job.package_path] > 0 && --remaining_variants[job.package_path] == 0)
+            {
+                m_buildJournal.setState(job.package_path, result == BuildStageResult::CACHED ? BuildJobState::CACHED : BuildJobState::SUCCEEDED);
+            }
+        }
+        return result;
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    prefetcher.wait();
+
+    // keep the resource usage of everything that ran for 'cmake_tool stats',
+    // the prefetch of a package is accounted to its first variant
+    BuildStats build_stats;
+    build_stats.load(_getBuildStatsPath());
+    for (const BuildJob &job : scheduler.getJobs())
+    {
+        if (job.state != BuildJobState::PENDING && job.state != BuildJobState::SKIPPED)
+        {
+            SourcePrefetcher::Stats prefetch_stats;
+            if (job.variant == variants.front())
+            {
+                prefetch_stats = prefetcher.getStats(job.package_path);
+            }
+            build_stats.addJob(job, prefetch_stats.read_seconds, prefetch_stats.cold_bytes);
+        }
+    }
+    if (!build_stats.save())
+    {
+        g_log << "Warning: could not save build stats to \"" << _getBuildStatsPath() << "\"" << std::endl;
+    }
+
+    if (redirect_output)
+    {
+        _printBuildSummary(scheduler.getJobs(), elapsed.count());
+    }
+    if (m_buildOptions.prefetch)
+    {
+        SourcePrefetcher::Stats prefetch_stats = prefetcher.getTotalStats();
+        char message[256];
+        snprintf(message, sizeof(message), "Prefetch: %zu files, %s (%s cold) in %.2fs beside configure, ~%.2fs of reads taken off the build",
+                 prefetch_stats.files, _formatMemory(prefetch_stats.bytes / 1024).c_str(), _formatMemory(prefetch_stats.cold_bytes / 1024).c_str(),
+                 prefetcher.getSeconds(), prefetch_stats.read_seconds);
+        if (redirect_output && !quiet)
+        {
+            std::cout << "    " << message << std::endl;
+        }
+        g_log << message << std::endl;
+    }
+    if (m_buildOptions.analyze_compile_time > 0)
+    {
+        _analyzeCompileTime(scheduler.getJobs());
+    }
+    return scheduler.getJobs();
+}
+
+void PackageTool::_benchmarkBuilds(const std::vector<BuildJob> &jobs)
+{
+    std::string program_name = StringUtils::trimmed(m_buildOptions.bench_program);
+    std::string program_args;
+    size_t pos = program_name.find(' ');
+    if (pos != std::string::npos)
+    {
+        program_args = program_name.substr(pos + 1);
+        program_name = program_name.substr(0, pos);
+    }
+
+    BenchmarkReport report;
+    for (const BuildJob &job : jobs)
+    {
+        std::string program_path = _getProgramPath(job.package_path, program_name, job.variant);
+        if (!FileUtils::fileExists(program_path))
+        {
+            continue;
+        }
+        BenchmarkEntry entry;
+        entry.name = FileUtils::getFileName(job.package_path) + (job.variant.empty() ? "" : " [" + job.variant + "]");
+        entry.program_path = program_path;
+        entry.compile_seconds = job.stage_seconds[0] + job.stage_seconds[1] + job.stage_seconds[2];
+        entry.binary_size = FileUtils::getFileSize(program_path);
+        entry.failed = job.state != BuildJobState::SUCCEEDED && job.state != BuildJobState::CACHED;
+        report.addEntry(entry);
+    }
+
+    std::cout << std::endl
+              << "Benchmark \"" << m_buildOptions.bench_program << "\", " << m_buildOptions.bench_runs << " runs per build" << std::endl;
+    report.run(program_args, m_buildOptions.bench_runs);
+    report.print();
+}
+
+void PackageTool::_analyzeCompileTime(const std::vector<BuildJob> &jobs)
+{
+    CompileTimeAnalyzer analyzer;
+    for (const BuildJob &job : jobs)
+    {
+        if (job.state != BuildJobState::SUCCEEDED || _getInstalledVariant(job.variant) == job.variant)
+        {
+            continue;
+        }
+        size_t count = analyzer.addBuildTree(job.build_path, FileUtils::getFileName(job.package_path) + (job.variant.empty() ? "" : " [" + job.variant + "]"));
+        g_log << "   " << count << " compile time traces of " << _getJobTitle(job) << std::endl;
+    }
+    analyzer.print(m_buildOptions.analyze_compile_time);
+}
+
+void PackageTool::_buildPackage(const std::string &package_path, bool quiet)
+{
+    std::vector<std::string> package_paths;
+    _findBuildPackages(package_path, package_paths);
+    _buildPackages(package_paths, quiet);
+}
+
+void PackageTool::buildPackage(const std::string &package_path, bool quiet)
+{
+    g_log << "-->> run cmake_tool build: " << package_path << std::endl;
+    _buildPackage(package_path, quiet);
+    g_log << "<<-- end cmake_tool build: " << package_path << std::endl
+          << std::endl;
+}
+
+void PackageTool::buildPackages(const std::vector<std::string> &package_paths, bool quiet)
+{
+    g_log << "-->> run cmake_tool build: " << StringUtils::join(package_paths, " ") << std::endl;
+    std::vector<std::string> found_paths;
+    for (const std::string &package_path : package_paths)
+    {
+        _findBuildPackages(package_path, found_paths);
+    }
+    std::vector<BuildJob> jobs = m_buildOptions.pgo_train.empty() ? _buildPackages(found_paths, quiet) : _buildPgoPackages(found_paths, quiet);
+    if (!m_buildOptions.bench_program.empty())
+    {
+        _benchmarkBuilds(jobs);
+    }
+    g_log << "<<-- end cmake_tool build: " << StringUtils::join(package_paths, " ") << std::endl
+          << std::endl;
+}
+
+// replaces the profiles of to_dir with the ones of from_dir
+static void _copyProfiles(const std::string &from_dir, const std::string &to_dir)
+{
+    if (FileUtils::isDirectory(to_dir))
+    {
+        FileUtils::deleteFolder(to_dir);
+    }
+    FileUtils::createDirectory(to_dir);
+    for (const std::string &file_path : FileUtils::getFileEntries(from_dir))
+    {
+        FileUtils::copyFile(file_path, FileUtils::buildFilePath(to_dir, FileUtils::getFileName(file_path)));
+    }
+}
 
-    size_t match_basename_count = match_basename_paths.size();
-    if (match_basename_count == 1)
+bool PackageTool::_restorePgoProfiles(const std::string &package_path, const std::string &variant)
+{
+    std::string cache_path = _getPgoCachePath(package_path, variant);
+    std::vector<std::string> lines;
+    if (!FileUtils::getFileLines(FileUtils::buildFilePath(cache_path, "fingerprint"), lines) || lines.empty() ||
+        StringUtils::trimmed(lines[0]) != _getPgoFingerprint(package_path, variant))
     {
-        _buildPackage(match_basename_paths[0], quiet);
+        return false;
     }
-    else if (match_basename_count > 1)
+
+    _copyProfiles(FileUtils::buildFilePath(cache_path, "profiles"), FileUtils::buildFilePath(_getVariantBuildPath(package_path, variant), "pgo"));
+    return true;
+}
+
+bool PackageTool::_trainPgoProfiles(const std::string &package_path, const std::string &variant)
+{
+    std::vector<std::string> train_args;
+    for (const std::string &arg : StringUtils::split(m_buildOptions.pgo_train, " "))
     {
-        if (m_force)
+        if (!arg.empty())
         {
-            for (const auto &path : match_basename_paths)
+            train_args.emplace_back(arg);
+        }
+    }
+
+    // run the instrumented program like 'cmake_tool run' does, it writes the raw profiles
+    std::string command = _getProgramPath(package_path, train_args[0], variant);
+    for (size_t i = 1; i < train_args.size(); ++i)
+    {
+        command += " " + train_args[i];
+    }
+    std::cout << "-- PGO training: " << command << std::endl;
+    g_log << "pgo training: " << command << std::endl;
+    if (0 != SystemUtils::executeShell(command))
+    {
+        std::cerr << "Error: PGO training \"" << command << "\" failed, the profiles are not used" << std::endl;
+        g_log << "Error: PGO training \"" << command << "\" failed" << std::endl;
+        return false;
+    }
+
+    // Clang writes raw profiles that have to be merged first, GCC updates its .gcda files in place
+    std::string profile_path = FileUtils::buildFilePath(_getVariantBuildPath(package_path, variant), "pgo");
+    if (!FileUtils::getFileEntries(profile_path, ".profraw").empty())
+    {
+        std::string merge_command = "llvm-profdata merge -output=\"" + FileUtils::buildFilePath(profile_path, "default.profdata") + "\" \"" +
+                                    profile_path + "\"/*.profraw";
+        if (0 != SystemUtils::executeShell(merge_command))
+        {
+            std::cerr << "Error: could not merge the profiles of \"" << profile_path << "\"" << std::endl;
+            g_log << "Error: could not merge the profiles of \"" << profile_path << "\"" << std::endl;
+            return false;
+        }
+    }
+    if (FileUtils::getFileEntries(profile_path).empty())
+    {
+        std::cerr << "Error: the training of \"" << package_path << "\" wrote no profiles to \"" << profile_path << "\"" << std::endl;
+        g_log << "Error: no profiles in \"" << profile_path << "\"" << std::endl;
+        return false;
+    }
+
+    // keep the profiles for later builds of the same sources
+    std::string cache_path = _getPgoCachePath(package_path, variant);
+    _copyProfiles(profile_path, FileUtils::buildFilePath(cache_path, "profiles"));
+    FileUtils::writeFileContents(FileUtils::buildFilePath(cache_path, "fingerprint"), _getPgoFingerprint(package_path, variant) + "\n");
+    return true;
+}
+
+std::vector<BuildJob> PackageTool::_buildPgoPackages(const std::vector<std::string> &package_paths, bool quiet)
+{
+    std::vector<std::string> variants;
+    for (const BuildVariant &build_variant : m_buildOptions.variants)
+    {
+        variants.emplace_back(build_variant.name);
+    }
+    if (variants.empty())
+    {
+        variants.emplace_back("");
+    }
+
+    // reuse cached profiles, only packages whose sources drifted are trained again
+    std::vector<std::string> pgo_paths;
+    std::vector<std::string> train_paths;
+    for (const std::string &package_path : package_paths)
+    {
+        std::string profile_cmake_path = FileUtils::buildFilePath(package_path, "cmake_tool_profile.cmake");
+        if (FileUtils::getFileContents(profile_cmake_path).find("CMAKE_TOOL_PGO") == std::string::npos)
+        {
+            std::cerr << "Error: \"" << profile_cmake_path << "\" has no profile guided optimization, create the package again or copy it from the template" << std::endl;
+            g_log << "Error: \"" << profile_cmake_path << "\" has no profile guided optimization" << std::endl;
+            continue;
+        }
+        pgo_paths.emplace_back(package_path);
+        for (const std::string &variant : variants)
+        {
+            if (!_restorePgoProfiles(package_path, variant))
             {
-                _buildPackage(path);
+                train_paths.emplace_back(package_path);
+                break;
             }
         }
-        else
+        if (train_paths.empty() || train_paths.back() != package_path)
         {
-            std::cout << "find " << match_basename_count << " packages named \"" << package_path << "\":" << std::endl;
-            for (const auto &path : match_basename_paths)
+            std::cout << "-- PGO profiles of \"" << package_path << "\" are up to date" << std::endl;
+        }
+    }
+
+    std::vector<std::string> cmake_args = m_buildOptions.cmake_args;
+    if (!train_paths.empty())
+    {
+        std::cout << "PGO: building " << train_paths.size() << " instrumented package(s)" << std::endl;
+        for (const std::string &package_path : train_paths)
+        {
+            for (const std::string &variant : variants)
             {
-                std::cout << "    " << path << std::endl;
+                // stale counters of an older build would be summed up with the new ones
+                std::string profile_path = FileUtils::buildFilePath(_getVariantBuildPath(package_path, variant), "pgo");
+                if (FileUtils::isDirectory(profile_path))
+                {
+                    FileUtils::deleteFolder(profile_path);
+                }
+            }
+        }
+        m_buildOptions.cmake_args.emplace_back("-DCMAKE_TOOL_PGO=generate");
+        std::vector<BuildJob> train_jobs = _buildPackages(train_paths, quiet);
+        m_buildOptions.cmake_args = cmake_args;
+
+        for (const BuildJob &job : train_jobs)
+        {
+            bool trained = (job.state == BuildJobState::SUCCEEDED || job.state == BuildJobState::CACHED) &&
+                           _trainPgoProfiles(job.package_path, job.variant);
+            if (!trained)
+            {
+                pgo_paths.erase(std::remove(pgo_paths.begin(), pgo_paths.end(), job.package_path), pgo_paths.end());
             }
-            std::cout << "please execute build with full package path, or add option \"-f\" to build all." << std::endl;
         }
     }
-}
 
-void PackageTool::buildPackage(const std::string &package_path, bool quiet)
-{
-    g_log << "-->> run cmake_tool build: " << package_path << std::endl;
-    _buildPackage(package_path, quiet);
-    g_log << "<<-- end cmake_tool build: " << package_path << std::endl
-          << std::endl;
+    if (pgo_paths.empty())
+    {
+        return std::vector<BuildJob>();
+    }
+    std::cout << "PGO: building " << pgo_paths.size() << " package(s) with the profiles" << std::endl;
+    m_buildOptions.cmake_args.emplace_back("-DCMAKE_TOOL_PGO=use");
+    std::vector<BuildJob> jobs = _buildPackages(pgo_paths, quiet);
+    m_buildOptions.cmake_args = cmake_args;
+    return jobs;
 }
 
 void PackageTool::_buildAllPackages(bool quiet)
@@ -714,10 +2037,10 @@ void PackageTool::_buildAllPackages(bool quiet)
         }
     }
 
-    for (const std::string &package_path : all_package_paths)
-    {
-        _buildPackage(package_path, quiet);
-    }
+    // record the plan, so an interrupted run can continue with 'build --resume'
+    m_buildJournal.create(_getBuildJournalPath());
+    _buildPackages(all_package_paths, quiet);
+    m_buildJournal.close();
 }
 
 void PackageTool::buildAllPackages(bool quiet)
@@ -728,6 +2051,333 @@ void PackageTool::buildAllPackages(bool quiet)
           << std::endl;
 }
 
+void PackageTool::_resumeBuild(bool quiet)
+{
+    if (m_createInfoPath.empty())
+    {
+        std::cerr << "Error: share path not find!" << std::endl;
+        g_log << "Error: share path not find!" << std::endl;
+        return;
+    }
+
+    if (!m_buildJournal.load(_getBuildJournalPath()))
+    {
+        std::cout << "No build to resume, run 'cmake_tool build -a' first." << std::endl;
+        return;
+    }
+
+    std::vector<std::string> package_paths;
+    for (const std::string &package_path : m_buildJournal.getUnfinishedPackages())
+    {
+        if (FileUtils::fileExists(package_path))
+        {
+            package_paths.emplace_back(package_path);
+        }
+        else
+        {
+            std::cout << "Warning: not find package [" << package_path << "]" << std::endl;
+            g_log << "Warning: not find package [" << package_path << "]" << std::endl;
+        }
+    }
+
+    if (package_paths.empty())
+    {
+        std::cout << "All packages of the last build are up to date." << std::endl;
+        m_buildJournal.close();
+        return;
+    }
+
+    std::cout << "Resume " << package_paths.size() << " packages: " << std::endl;
+    for (const std::string &package_path : package_paths)
+    {
+        std::cout << "    " << package_path << std::endl;
+    }
+
+    _buildPackages(package_paths, quiet);
+    m_buildJournal.close();
+}
+
+void PackageTool::resumeBuild(bool quiet)
+{
+    g_log << "-->> run cmake_tool build resume" << std::endl;
+    _resumeBuild(quiet);
+    g_log << "<<-- end cmake_tool build resume" << std::endl
+          << std::endl;
+}
+
+void PackageTool::_watchPackages(const std::vector<std::string> &package_paths, bool quiet)
+{
+    std::vector<std::string> found_paths;
+    for (const std::string &package_path : package_paths)
+    {
+        _findBuildPackages(package_path, found_paths);
+    }
+    if (found_paths.empty())
+    {
+        return;
+    }
+
+    PackageWatcher watcher;
+    for (const std::string &package_path : found_paths)
+    {
+        if (!watcher.addPackage(package_path))
+        {
+            return;
+        }
+    }
+
+    _buildPackages(found_paths, quiet);
+
+    PackageGraph graph;
+    for (const std::string &package_path : found_paths)
+    {
+        graph.addPackage(package_path);
+    }
+    graph.resolve();
+
+    std::set<std::string> changed_packages;
+    while (true)
+    {
+        std::cout << std::endl
+                  << "Watching " << found_paths.size() << " packages (" << watcher.getWatchCount()
+                  << " directories) for changes, press Ctrl-C to stop." << std::endl;
+        if (!watcher.waitForChanges(changed_packages))
+        {
+            return;
+        }
+
+        // rebuild the changed packages and everything depending on them
+        std::set<std::string> affected_packages = changed_packages;
+        for (const std::string &package_path : changed_packages)
+        {
+            std::set<std::string> dependents = graph.getDependents(package_path);
+            affected_packages.insert(dependents.begin(), dependents.end());
+        }
+        std::vector<std::string> rebuild_paths;
+        for (const std::string &package_path : found_paths)
+        {
+            if (affected_packages.count(package_path))
+            {
+                rebuild_paths.emplace_back(package_path);
+            }
+        }
+
+        for (const std::string &package_path : changed_packages)
+        {
+            std::cout << "Changed: \"" << package_path << "\"" << std::endl;
+            g_log << "watch changed: \"" << package_path << "\"" << std::endl;
+        }
+        _buildPackages(rebuild_paths, quiet);
+    }
+}
+
+void PackageTool::watchPackages(const std::vector<std::string> &package_paths, bool quiet)
+{
+    g_log << "-->> run cmake_tool build watch: " << StringUtils::join(package_paths, " ") << std::endl;
+    _watchPackages(package_paths, quiet);
+    g_log << "<<-- end cmake_tool build watch: " << StringUtils::join(package_paths, " ") << std::endl
+          << std::endl;
+}
+
+bool PackageTool::_syncPackageSources(const std::string &package_path, bool quiet)
+{
+    switch (SourceSync::sync(package_path))
+    {
+    case SourceSync::Result::NOT_USED:
+        if (!quiet)
+        {
+            std::cout << "\"" << package_path << "\": CMakeLists.txt does not include sources.cmake, nothing to sync" << std::endl;
+        }
+        return true;
+    case SourceSync::Result::UNCHANGED:
+        if (!quiet)
+        {
+            std::cout << "\"" << package_path << "\": sources.cmake is up to date" << std::endl;
+        }
+        return true;
+    case SourceSync::Result::UPDATED:
+        {
+            std::lock_guard<std::mutex> lock(g_output_mutex);
+            std::cout << "-- Updated \"" << SourceSync::getSourcesPath(package_path) << "\"" << std::endl;
+            g_log << "sources updated: \"" << SourceSync::getSourcesPath(package_path) << "\"" << std::endl;
+        }
+        return true;
+    case SourceSync::Result::FAILED:
+        break;
+    }
+    std::cerr << "Error: could not write \"" << SourceSync::getSourcesPath(package_path) << "\"" << std::endl;
+    g_log << "Error: could not write \"" << SourceSync::getSourcesPath(package_path) << "\"" << std::endl;
+    return false;
+}
+
+void PackageTool::_syncSources(const std::vector<std::string> &package_paths, bool quiet)
+{
+    std::vector<std::string> found_paths;
+    for (const std::string &package_path : package_paths)
+    {
+        _findBuildPackages(package_path, found_paths);
+    }
+    for (const std::string &package_path : found_paths)
+    {
+        _syncPackageSources(package_path, quiet);
+    }
+}
+
+void PackageTool::syncSources(const std::vector<std::string> &package_paths, bool quiet)
+{
+    g_log << "-->> run cmake_tool sync-sources: " << StringUtils::join(package_paths, " ") << std::endl;
+    _syncSources(package_paths, quiet);
+    g_log << "<<-- end cmake_tool sync-sources: " << StringUtils::join(package_paths, " ") << std::endl
+          << std::endl;
+}
+
+void PackageTool::_syncAllSources(bool quiet)
+{
+    if (m_createInfoPath.empty())
+    {
+        std::cerr << "Error: share path not find!" << std::endl;
+        g_log << "Error: share path not find!" << std::endl;
+        return;
+    }
+
+    std::vector<std::string> all_package_paths;
+    _getAllPackagePaths(all_package_paths);
+    for (const std::string &package_path : all_package_paths)
+    {
+        _syncPackageSources(package_path, quiet);
+    }
+}
+
+void PackageTool::syncAllSources(bool quiet)
+{
+    g_log << "-->> run cmake_tool sync-sources all packages" << std::endl;
+    _syncAllSources(quiet);
+    g_log << "<<-- end cmake_tool sync-sources all packages" << std::endl
+          << std::endl;
+}
+
+void PackageTool::_suggestPch(const std::string &package_path, size_t max_count, bool write)
+{
+    std::vector<std::string> found_paths;
+    _findBuildPackages(package_path, found_paths);
+    for (const std::string &path : found_paths)
+    {
+        PchAdvisor advisor(SystemUtils::getNumCPUThreads());
+        advisor.scan(path);
+        std::vector<PchAdvisor::Candidate> candidates = advisor.suggest(max_count);
+
+        printf("Scanned %zu sources and headers of \"%s\" in %.2fs\n", advisor.getFileCount(), path.c_str(), advisor.getSeconds());
+        if (candidates.empty())
+        {
+            printf("No header is included by more than one file, a precompiled header would not help.\n");
+            continue;
+        }
+
+        printf("\n%-11s  %-6s  %s\n", "Included", "Kind", "Header");
+        for (const PchAdvisor::Candidate &candidate : candidates)
+        {
+            printf("%4zu (%3zu%%)  %-6s  %s\n", candidate.file_count, candidate.file_count * 100 / advisor.getFileCount(),
+                   candidate.system ? "system" : "local", candidate.header.c_str());
+        }
+        std::vector<PchAdvisor::Candidate> recent = advisor.getRecentlyChanged();
+        if (!recent.empty())
+        {
+            printf("\nLeft out, changed in the last 7 days:\n");
+            for (const PchAdvisor::Candidate &candidate : recent)
+            {
+                printf("%4zu%9s%-6s  %s\n", candidate.file_count, "", "local", candidate.header.c_str());
+            }
+        }
+
+        std::string contents = PchAdvisor::getPchContents(candidates);
+        if (!write)
+        {
+            printf("\nProposed include/pch.hpp, write it with '--write':\n\n%s", contents.c_str());
+            continue;
+        }
+
+        std::string pch_path = FileUtils::buildFilePath(path, "include/pch.hpp");
+        FileUtils::createDirectory(FileUtils::buildFilePath(path, "include/"));
+        if (!FileUtils::writeFileContents(pch_path, contents))
+        {
+            std::cerr << "Error: could not write \"" << pch_path << "\"" << std::endl;
+            g_log << "Error: could not write \"" << pch_path << "\"" << std::endl;
+            continue;
+        }
+        printf("\n-- Updated \"%s\", precompiled once TARGET_PCH is on, e.g. 'cmake_tool build --pch'\n", pch_path.c_str());
+        g_log << "pch updated: \"" << pch_path << "\"" << std::endl;
+    }
+}
+
+void PackageTool::suggestPch(const std::string &package_path, size_t max_count, bool write)
+{
+    g_log << "-->> run cmake_tool pch-suggest: " << package_path << std::endl;
+    _suggestPch(package_path, max_count, write);
+    g_log << "<<-- end cmake_tool pch-suggest: " << package_path << std::endl
+          << std::endl;
+}
+
+void PackageTool::_addComponent(const std::string &package_path, const std::string &component_name)
+{
+    // the name is the folder, the namespace and the suffix of the target ${PROJECT_NAME}_<name>
+    bool valid_name = !component_name.empty() && !isdigit(static_cast<unsigned char>(component_name[0]));
+    for (char c : component_name)
+    {
+        valid_name = valid_name && (isalnum(static_cast<unsigned char>(c)) || c == '_');
+    }
+    if (!valid_name)
+    {
+        std::cerr << "Error: invalid component name \"" << component_name << "\", use letters, digits and '_'" << std::endl;
+        g_log << "Error: invalid component name \"" << component_name << "\"" << std::endl;
+        return;
+    }
+
+    std::vector<std::string> found_paths;
+    _findBuildPackages(package_path, found_paths);
+    if (found_paths.size() != 1)
+    {
+        std::cerr << "Error: \"" << package_path << "\" does not name exactly one package" << std::endl;
+        g_log << "Error: \"" << package_path << "\" does not name exactly one package" << std::endl;
+        return;
+    }
+    const std::string &path = found_paths[0];
+    if (!FileUtils::fileExists(SourceSync::getComponentsPath(path)))
+    {
+        std::cerr << "Error: \"" << path << "\" has no components.cmake, create it with 'cmake_tool create --layout modular'" << std::endl;
+        g_log << "Error: \"" << path << "\" has no components.cmake" << std::endl;
+        return;
+    }
+    std::string component_path = FileUtils::buildFilePath(path, "src/" + component_name);
+    if (FileUtils::fileExists(component_path))
+    {
+        std::cerr << "Error: \"" << component_path << "\" already exists" << std::endl;
+        g_log << "Error: \"" << component_path << "\" already exists" << std::endl;
+        return;
+    }
+
+    _updateCurrentPackage(path, PackageType::CMAKE_CPP_PACKAGE);
+    g_log << "_addComponent" << std::endl
+          << "{" << std::endl;
+    _createComponent(component_name);
+    g_log << "}" << std::endl;
+    if (SourceSync::sync(path) == SourceSync::Result::FAILED)
+    {
+        std::cerr << "Error: could not write \"" << SourceSync::getComponentsPath(path) << "\"" << std::endl;
+        g_log << "Error: could not write \"" << SourceSync::getComponentsPath(path) << "\"" << std::endl;
+        return;
+    }
+    printf("-- Added component \"%s\" to \"%s\", linked into the executable as %s_%s\n", component_name.c_str(), path.c_str(),
+           FileUtils::getFileName(path).c_str(), component_name.c_str());
+}
+
+void PackageTool::addComponent(const std::string &package_path, const std::string &component_name)
+{
+    g_log << "-->> run cmake_tool add-component: " << package_path << " " << component_name << std::endl;
+    _addComponent(package_path, component_name);
+    g_log << "<<-- end cmake_tool add-component: " << package_path << " " << component_name << std::endl
+          << std::endl;
+}
+
 void PackageTool::_cleanPackage(const std::string &package_path, bool quiet)
 {
     if (StringUtils::trimmed(package_path).empty())
@@ -774,7 +2424,7 @@ void PackageTool::_cleanPackage(const std::string &package_path, bool quiet)
             package_find = true;
             if (FileUtils::fileExists(m_currentPackage.path))
             {
-                std::string cache_path = FileUtils::buildFilePath(m_currentPackage.path, "build/");
+                std::string cache_path = m_buildRoot.getBuildPath(m_currentPackage.path);
                 if (!quiet)
                 {
                     std::cout << std::endl
@@ -1179,7 +2829,7 @@ void PackageTool::resetInfo()
           << std::endl;
 }
 
-void PackageTool::_runPackage(const std::string &package_path, const std::string &program_name, const std::vector<std::string> &program_args)
+void PackageTool::_runPackage(const std::string &package_path, const std::string &program_name, const std::vector<std::string> &program_args, const std::string &variant)
 {
     if (StringUtils::trimmed(package_path).empty())
     {
@@ -1223,7 +2873,7 @@ void PackageTool::_runPackage(const std::string &package_path, const std::string
             package_find = true;
             if (FileUtils::fileExists(m_currentPackage.path))
             {
-                std::string program_path = FileUtils::buildFilePath(m_currentPackage.path, "bin/" + program_name);
+                std::string program_path = _getProgramPath(m_currentPackage.path, program_name, variant);
                 // SystemUtils::appendEnvValue("PATH", FileUtils::buildFilePath(m_currentPackage.path, "bin/"));
                 for (const std::string &program_arg : program_args)
                 {
@@ -1259,7 +2909,7 @@ void PackageTool::_runPackage(const std::string &package_path, const std::string
     size_t match_basename_count = match_basename_paths.size();
     if (match_basename_count == 1)
     {
-        std::string program_path = FileUtils::buildFilePath(match_basename_paths[0], "bin/" + program_name);
+        std::string program_path = _getProgramPath(match_basename_paths[0], program_name, variant);
         // SystemUtils::appendEnvValue("PATH", FileUtils::buildFilePath(match_basename_paths[0], "bin/"));
         for (const std::string &program_arg : program_args)
         {
@@ -1282,10 +2932,10 @@ void PackageTool::_runPackage(const std::string &package_path, const std::string
     }
 }
 
-void PackageTool::runPackage(const std::string &package_path, const std::string &program_name, const std::vector<std::string> &program_args)
+void PackageTool::runPackage(const std::string &package_path, const std::string &program_name, const std::vector<std::string> &program_args, const std::string &variant)
 {
     g_log << "-->> run cmake_tool run: " << package_path << std::endl;
-    _runPackage(package_path, program_name, program_args);
+    _runPackage(package_path, program_name, program_args, variant);
     g_log << "<<-- end cmake_tool run: " << package_path << std::endl
           << std::endl;
 }
@@ -0,0 +1,235 @@
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "PackageWatcher.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/StringUtils.h"
+
+// sub directories of a package holding its sources
+static const char *s_source_dirs[] = {"src", "include"};
+
+static const uint32_t s_root_mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE | IN_ONLYDIR;
+static const uint32_t s_source_mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE | IN_DELETE_SELF | IN_ONLYDIR;
+
+static bool isCMakeFile(const std::string &name)
+{
+    // sources.cmake is generated from the source tree, which is watched anyway
+    return name == "CMakeLists.txt" || (StringUtils::endsWith(name, ".cmake") && name != "sources.cmake");
+}
+
+static bool isIgnoredFile(const std::string &name)
+{
+    // hidden files and editor backups
+    return name.empty() || name.front() == '.' || name.back() == '~' ||
+           StringUtils::endsWith(name, ".swp") || StringUtils::endsWith(name, ".swx");
+}
+
+PackageWatcher::PackageWatcher(int debounce_ms)
+    : m_debounceMs(debounce_ms)
+{
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+    {
+        std::cerr << "Error: inotify_init1 failed: " << strerror(errno) << std::endl;
+    }
+}
+
+PackageWatcher::~PackageWatcher()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+    }
+}
+
+bool PackageWatcher::_addWatch(const std::string &package_path, const std::string &dir_path, bool package_root)
+{
+    int wd = inotify_add_watch(m_fd, dir_path.c_str(), package_root ? s_root_mask : s_source_mask);
+    if (wd < 0)
+    {
+        if (errno == ENOSPC)
+        {
+            std::cerr << "Error: out of inotify watches, raise fs.inotify.max_user_watches (now watching "
+                      << m_watches.size() << " directories)." << std::endl;
+        }
+        else
+        {
+            std::cerr << "Error: can not watch \"" << dir_path << "\": " << strerror(errno) << std::endl;
+        }
+        return false;
+    }
+    m_watches[wd] = {package_path, dir_path, package_root};
+    return true;
+}
+
+bool PackageWatcher::_addWatchRecursive(const std::string &package_path, const std::string &dir_path)
+{
+    if (!_addWatch(package_path, dir_path, false))
+    {
+        return false;
+    }
+    for (const std::string &sub_dir : FileUtils::getFolderEntries(dir_path))
+    {
+        if (!isIgnoredFile(FileUtils::getFileName(sub_dir)) && !_addWatchRecursive(package_path, sub_dir))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PackageWatcher::addPackage(const std::string &package_path)
+{
+    if (m_fd < 0 || !_addWatch(package_path, package_path, true))
+    {
+        return false;
+    }
+    for (const char *source_dir : s_source_dirs)
+    {
+        std::string dir_path = FileUtils::buildFilePath(package_path, source_dir);
+        if (FileUtils::isDirectory(dir_path) && !_addWatchRecursive(package_path, dir_path))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PackageWatcher::_readEvents(std::set<std::string> &changed_packages)
+{
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    while (true)
+    {
+        ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno == EAGAIN;
+        }
+
+        for (char *ptr = buffer; ptr < buffer + length;)
+        {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                // events were dropped, rebuild everything that is watched
+                for (const auto &watch : m_watches)
+                {
+                    changed_packages.insert(watch.second.package_path);
+                }
+                continue;
+            }
+
+            auto it = m_watches.find(event->wd);
+            if (it == m_watches.end())
+            {
+                continue;
+            }
+            if (event->mask & IN_IGNORED)
+            {
+                m_watches.erase(it);
+                continue;
+            }
+
+            const Watch watch = it->second;
+            std::string name = event->len > 0 ? event->name : "";
+            bool is_dir = (event->mask & IN_ISDIR) != 0;
+
+            if (watch.package_root)
+            {
+                if (is_dir && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+                {
+                    for (const char *source_dir : s_source_dirs)
+                    {
+                        if (name == source_dir)
+                        {
+                            _addWatchRecursive(watch.package_path, FileUtils::buildFilePath(watch.dir_path, name));
+                            changed_packages.insert(watch.package_path);
+                        }
+                    }
+                }
+                else if (!is_dir && isCMakeFile(name))
+                {
+                    changed_packages.insert(watch.package_path);
+                }
+                continue;
+            }
+
+            if (is_dir)
+            {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    _addWatchRecursive(watch.package_path, FileUtils::buildFilePath(watch.dir_path, name));
+                }
+                changed_packages.insert(watch.package_path);
+            }
+            else if (event->mask & IN_DELETE_SELF)
+            {
+                changed_packages.insert(watch.package_path);
+            }
+            else if (!isIgnoredFile(name) && !(event->mask & IN_CREATE))
+            {
+                // a created file is reported again by IN_CLOSE_WRITE once it is written
+                changed_packages.insert(watch.package_path);
+            }
+        }
+    }
+}
+
+bool PackageWatcher::waitForChanges(std::set<std::string> &changed_packages)
+{
+    if (m_fd < 0)
+    {
+        return false;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+
+    changed_packages.clear();
+    int timeout = -1;
+    while (true)
+    {
+        int ret = poll(&pfd, 1, timeout);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "Error: poll failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        if (ret == 0)
+        {
+            // quiet for the debounce interval
+            if (!changed_packages.empty())
+            {
+                return true;
+            }
+            timeout = -1;
+            continue;
+        }
+        if (!_readEvents(changed_packages))
+        {
+            std::cerr << "Error: read inotify events failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        if (!changed_packages.empty())
+        {
+            timeout = m_debounceMs;
+        }
+    }
+}
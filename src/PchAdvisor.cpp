@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+#include <sys/stat.h>
+
+#include "PchAdvisor.hpp"
+
+#include "utils/FileUtils.h"
+
+// package headers modified within this time are left out of the precompiled header
+static const time_t s_recent_seconds = 7 * 24 * 60 * 60;
+
+static bool _parseInclude(const std::string &line, std::string &header)
+{
+    size_t pos = line.find_first_not_of(" \t");
+    if (pos == std::string::npos || line[pos] != '#')
+    {
+        return false;
+    }
+    pos = line.find_first_not_of(" \t", pos + 1);
+    if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+    {
+        return false;
+    }
+    pos = line.find_first_not_of(" \t", pos + 7);
+    if (pos == std::string::npos || (line[pos] != '<' && line[pos] != '"'))
+    {
+        return false;
+    }
+    size_t end = line.find(line[pos] == '<' ? '>' : '"', pos + 1);
+    if (end == std::string::npos || end == pos + 1)
+    {
+        return false;
+    }
+    header = line.substr(pos, end - pos + 1);
+    return true;
+}
+
+PchAdvisor::PchAdvisor(size_t thread_count)
+    : m_threadCount(thread_count > 0 ? thread_count : 1)
+{
+}
+
+bool PchAdvisor::_isRecentlyChanged(const std::string &file_path, const std::string &header_name) const
+{
+    // resolve like the compiler would: next to the includer first, then the package include paths
+    for (const std::string &dir_path : {FileUtils::getDirPath(file_path),
+                                        FileUtils::buildFilePath(m_packagePath, "include"),
+                                        FileUtils::buildFilePath(m_packagePath, "src")})
+    {
+        struct stat header_stat;
+        if (0 == stat(FileUtils::buildFilePath(dir_path, header_name).c_str(), &header_stat))
+        {
+            return header_stat.st_mtime + s_recent_seconds > time(nullptr);
+        }
+    }
+    // not part of the package, e.g. a header of an installed dependency
+    return false;
+}
+
+void PchAdvisor::_scanFile(const std::string &file_path)
+{
+    std::vector<std::string> headers;
+    for (const std::string &line : FileUtils::getFileLines(file_path))
+    {
+        std::string header;
+        if (_parseInclude(line, header) && std::find(headers.begin(), headers.end(), header) == headers.end())
+        {
+            headers.emplace_back(header);
+        }
+    }
+
+    for (const std::string &header : headers)
+    {
+        bool system = header[0] == '<';
+        std::string header_name = header.substr(1, header.size() - 2);
+        if (FileUtils::getFileName(header_name) == "pch.hpp")
+        {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_candidates.find(header);
+            if (it != m_candidates.end())
+            {
+                ++it->second.file_count;
+                continue;
+            }
+        }
+
+        Candidate candidate;
+        candidate.header = header;
+        candidate.file_count = 1;
+        candidate.system = system;
+        candidate.recently_changed = !system && _isRecentlyChanged(file_path, header_name);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto inserted = m_candidates.emplace(header, candidate);
+        if (!inserted.second)
+        {
+            ++inserted.first->second.file_count;
+        }
+    }
+}
+
+void PchAdvisor::scan(const std::string &package_path)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    m_packagePath = package_path;
+    m_candidates.clear();
+
+    static const std::vector<std::string> s_extensions = {".c", ".cc", ".cpp", ".cxx", ".h", ".hh", ".hpp", ".hxx"};
+    std::vector<std::string> file_paths;
+    for (const char *dir_name : {"src", "include"})
+    {
+        std::string dir_path = FileUtils::buildFilePath(package_path, dir_name);
+        if (FileUtils::isDirectory(dir_path))
+        {
+            FileUtils::getRecursiveFileEntries(dir_path, s_extensions, file_paths);
+        }
+    }
+    // the current precompiled header would only vote for itself
+    file_paths.erase(std::remove_if(file_paths.begin(), file_paths.end(), [](const std::string &file_path) {
+                         return FileUtils::getFileName(file_path) == "pch.hpp";
+                     }),
+                     file_paths.end());
+    m_fileCount = file_paths.size();
+
+    std::atomic<size_t> next_file(0);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < m_threadCount && i < file_paths.size(); ++i)
+    {
+        workers.emplace_back([this, &file_paths, &next_file]() {
+            size_t index;
+            while ((index = next_file++) < file_paths.size())
+            {
+                _scanFile(file_paths[index]);
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_seconds = elapsed.count();
+}
+
+std::vector<PchAdvisor::Candidate> PchAdvisor::_getCandidates(size_t min_files, bool recently_changed) const
+{
+    std::vector<Candidate> candidates;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &entry : m_candidates)
+    {
+        if (entry.second.file_count >= min_files && entry.second.recently_changed == recently_changed)
+        {
+            candidates.emplace_back(entry.second);
+        }
+    }
+    // most included first, system headers before package headers on a tie
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        if (a.file_count != b.file_count)
+        {
+            return a.file_count > b.file_count;
+        }
+        return a.system && !b.system;
+    });
+    return candidates;
+}
+
+std::vector<PchAdvisor::Candidate> PchAdvisor::suggest(size_t max_count, size_t min_files) const
+{
+    std::vector<Candidate> candidates = _getCandidates(min_files, false);
+    if (max_count > 0 && candidates.size() > max_count)
+    {
+        candidates.resize(max_count);
+    }
+    return candidates;
+}
+
+std::vector<PchAdvisor::Candidate> PchAdvisor::getRecentlyChanged(size_t min_files) const
+{
+    return _getCandidates(min_files, true);
+}
+
+std::string PchAdvisor::getPchContents(const std::vector<Candidate> &candidates)
+{
+    std::string contents = "#pragma once\n\n// Generated by 'cmake_tool pch-suggest', precompiled by the TARGET_PCH option of CMakeLists.txt\n\n";
+    // system headers first, they do not depend on the package headers
+    for (bool system : {true, false})
+    {
+        for (const Candidate &candidate : candidates)
+        {
+            if (candidate.system == system)
+            {
+                contents += "#include " + candidate.header + "\n";
+            }
+        }
+    }
+    return contents;
+}
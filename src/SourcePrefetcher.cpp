@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <chrono>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SourcePrefetcher.hpp"
+
+#include "utils/FileUtils.h"
+
+SourcePrefetcher::SourcePrefetcher(size_t thread_count)
+    : m_threadCount(thread_count > 0 ? thread_count : 1)
+{
+}
+
+SourcePrefetcher::~SourcePrefetcher()
+{
+    wait();
+}
+
+void SourcePrefetcher::addPackage(const std::string &package_path)
+{
+    m_packagePaths.emplace_back(package_path);
+    m_stats.emplace_back(Stats());
+}
+
+void SourcePrefetcher::start()
+{
+    if (!m_thread.joinable() && !m_packagePaths.empty())
+    {
+        m_thread = std::thread(&SourcePrefetcher::_run, this);
+    }
+}
+
+void SourcePrefetcher::wait()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+SourcePrefetcher::Stats SourcePrefetcher::getStats(const std::string &package_path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_packagePaths.size(); ++i)
+    {
+        if (m_packagePaths[i] == package_path)
+        {
+            return m_stats[i];
+        }
+    }
+    return Stats();
+}
+
+SourcePrefetcher::Stats SourcePrefetcher::getTotalStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats total;
+    for (const Stats &stats : m_stats)
+    {
+        total.files += stats.files;
+        total.bytes += stats.bytes;
+        total.cold_bytes += stats.cold_bytes;
+        total.read_seconds += stats.read_seconds;
+    }
+    return total;
+}
+
+void SourcePrefetcher::_prefetchFile(size_t package_index, const std::string &file_path)
+{
+    int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0)
+    {
+        close(fd);
+        return;
+    }
+    size_t size = static_cast<size_t>(file_stat.st_size);
+
+    // count the pages not yet cached, warm files cost nothing
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<unsigned char> residency((size + page_size - 1) / page_size, 0);
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping != MAP_FAILED)
+    {
+        if (0 != mincore(mapping, size, residency.data()))
+        {
+            std::fill(residency.begin(), residency.end(), 0);
+        }
+        munmap(mapping, size);
+    }
+    std::uint64_t cold_bytes = 0;
+    for (unsigned char page : residency)
+    {
+        cold_bytes += (page & 1) ? 0 : page_size;
+    }
+    cold_bytes = std::min<std::uint64_t>(cold_bytes, size);
+
+    // read the cold pages, the time the reads take is what the compilers no longer wait for
+    double read_seconds = 0.0;
+    if (cold_bytes > 0)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        char buffer[64 * 1024];
+        size_t page = 0;
+        while (page < residency.size())
+        {
+            if (residency[page] & 1)
+            {
+                ++page;
+                continue;
+            }
+            size_t first_page = page;
+            while (page < residency.size() && !(residency[page] & 1))
+            {
+                ++page;
+            }
+            off_t offset = static_cast<off_t>(first_page * page_size);
+            off_t end = static_cast<off_t>(std::min(page * page_size, size));
+            while (offset < end)
+            {
+                ssize_t count = pread(fd, buffer, std::min<size_t>(sizeof(buffer), static_cast<size_t>(end - offset)), offset);
+                if (count <= 0)
+                {
+                    break;
+                }
+                offset += count;
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        read_seconds = elapsed.count();
+    }
+    close(fd);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats &stats = m_stats[package_index];
+    ++stats.files;
+    stats.bytes += size;
+    stats.cold_bytes += cold_bytes;
+    stats.read_seconds += read_seconds;
+}
+
+void SourcePrefetcher::_run()
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < m_packagePaths.size(); ++i)
+    {
+        const std::string &package_path = m_packagePaths[i];
+        std::vector<std::string> file_paths = FileUtils::getFileEntries(package_path, ".cmake");
+        file_paths.emplace_back(FileUtils::buildFilePath(package_path, "CMakeLists.txt"));
+        for (const char *dir_name : {"src", "include"})
+        {
+            std::string dir_path = FileUtils::buildFilePath(package_path, dir_name);
+            if (FileUtils::isDirectory(dir_path))
+            {
+                FileUtils::getRecursiveFileEntries(dir_path, std::vector<std::string>(), file_paths);
+            }
+        }
+        for (const std::string &file_path : file_paths)
+        {
+            m_files.emplace_back(i, file_path);
+        }
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < m_threadCount && i < m_files.size(); ++i)
+    {
+        workers.emplace_back([this]() {
+            size_t index;
+            while ((index = m_nextFile++) < m_files.size())
+            {
+                _prefetchFile(m_files[index].first, m_files[index].second);
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_seconds = elapsed.count();
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+
+#include <fnmatch.h>
+
+#include "SourceSync.hpp"
+
+#include "utils/FileUtils.h"
+#include "utils/StringUtils.h"
+
+static const char *s_sources_file = "sources.cmake";
+static const char *s_sources_header = "# Generated by 'cmake_tool sync-sources', do not edit.\n";
+static const char *s_components_file = "components.cmake";
+static const char *s_components_header = "# Generated by 'cmake_tool sync-sources' and 'cmake_tool add-component', do not edit.\n";
+
+std::string SourceSync::getSourcesPath(const std::string &package_path)
+{
+    return FileUtils::buildFilePath(package_path, s_sources_file);
+}
+
+std::string SourceSync::getComponentsPath(const std::string &package_path)
+{
+    return FileUtils::buildFilePath(package_path, s_components_file);
+}
+
+std::vector<std::string> SourceSync::getComponents(const std::string &package_path)
+{
+    // a component is a folder of src/ with its own CMakeLists.txt
+    std::string src_path = FileUtils::buildFilePath(package_path, "src/");
+    std::vector<std::string> components;
+    for (const std::string &name : FileUtils::getFileEntries(src_path, "", false))
+    {
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+        std::string component_path = FileUtils::buildFilePath(src_path, name);
+        if (FileUtils::isDirectory(component_path) && FileUtils::fileExists(FileUtils::buildFilePath(component_path, "CMakeLists.txt")))
+        {
+            components.emplace_back(name);
+        }
+    }
+    std::sort(components.begin(), components.end());
+    return components;
+}
+
+bool SourceSync::_readGlobs(const std::string &cmake_path, std::vector<SourceGlob> &globs)
+{
+    bool uses_sources = false;
+    for (std::string line : FileUtils::getFileLines(cmake_path))
+    {
+        line = StringUtils::trimmed(line.substr(0, line.find('#')));
+        if (line.find(s_sources_file) != std::string::npos)
+        {
+            uses_sources = true;
+        }
+
+        // file(GLOB <variable> "<dir>/<wildcard>" ...), only the first pattern is taken
+        std::string lower_line = StringUtils::toLower(line);
+        if (!StringUtils::startsWith(lower_line, "file(") || lower_line.find("glob") == std::string::npos)
+        {
+            continue;
+        }
+        std::string args = line.substr(line.find('(') + 1);
+        args = args.substr(0, args.find(')'));
+        std::vector<std::string> tokens;
+        for (const std::string &token : StringUtils::split(args, " "))
+        {
+            if (!StringUtils::trimmed(token).empty())
+            {
+                tokens.emplace_back(StringUtils::replace(StringUtils::trimmed(token), "\"", ""));
+            }
+        }
+        if (tokens.size() >= 3 && StringUtils::equals(tokens[0], "GLOB"))
+        {
+            globs.push_back({tokens[1], tokens[2]});
+        }
+    }
+    return uses_sources;
+}
+
+std::vector<std::string> SourceSync::_matchFiles(const std::string &package_path, const std::string &pattern)
+{
+    std::string dir_name = FileUtils::getDirPath(pattern);
+    std::string wildcard = FileUtils::getFileName(pattern);
+
+    std::vector<std::string> files;
+    for (const std::string &file_name : FileUtils::getFileEntries(FileUtils::buildFilePath(package_path, dir_name), "", false))
+    {
+        if (0 == fnmatch(wildcard.c_str(), file_name.c_str(), 0))
+        {
+            files.emplace_back(dir_name + file_name);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+SourceSync::Result SourceSync::_writeIfChanged(const std::string &path, const std::string &contents)
+{
+    // an untouched file keeps CMake from reconfiguring
+    if (FileUtils::fileExists(path) && FileUtils::getFileContents(path) == contents)
+    {
+        return Result::UNCHANGED;
+    }
+    return FileUtils::writeFileContents(path, contents) ? Result::UPDATED : Result::FAILED;
+}
+
+SourceSync::Result SourceSync::_syncSources(const std::string &dir_path, const SourceGlob &fallback_glob)
+{
+    std::vector<SourceGlob> globs;
+    if (!_readGlobs(FileUtils::buildFilePath(dir_path, "CMakeLists.txt"), globs))
+    {
+        return Result::NOT_USED;
+    }
+    if (globs.empty())
+    {
+        globs.push_back(fallback_glob);
+    }
+
+    std::string contents = s_sources_header;
+    for (const SourceGlob &glob : globs)
+    {
+        contents += "set(" + glob.variable + "\n";
+        for (const std::string &file : _matchFiles(dir_path, glob.pattern))
+        {
+            contents += "    " + file + "\n";
+        }
+        contents += ")\n";
+    }
+    return _writeIfChanged(getSourcesPath(dir_path), contents);
+}
+
+SourceSync::Result SourceSync::sync(const std::string &package_path)
+{
+    Result result = _syncSources(package_path, {"TARGET_EXE_SRCS", "src/*.cpp"});
+    // the benchmarks of 'cmake_tool create --with-bench' list their sources in bench/sources.cmake
+    std::string bench_path = FileUtils::buildFilePath(package_path, "bench");
+    if (FileUtils::fileExists(FileUtils::buildFilePath(bench_path, "CMakeLists.txt")))
+    {
+        result = std::max(result, _syncSources(bench_path, {"TARGET_BENCH_SRCS", "*.cpp"}));
+    }
+
+    std::string components_path = getComponentsPath(package_path);
+    if (!FileUtils::fileExists(components_path))
+    {
+        return result;
+    }
+
+    // the worst result of the package and its components wins, FAILED over UPDATED over UNCHANGED
+    std::vector<std::string> components = getComponents(package_path);
+    std::string contents = s_components_header;
+    contents += "set(TARGET_COMPONENTS\n";
+    for (const std::string &component : components)
+    {
+        contents += "    " + component + "\n";
+    }
+    contents += ")\n";
+    result = std::max(result, _writeIfChanged(components_path, contents));
+    for (const std::string &component : components)
+    {
+        std::string component_path = FileUtils::buildFilePath(package_path, "src/" + component);
+        result = std::max(result, _syncSources(component_path, {"TARGET_COMPONENT_SRCS", "*.cpp"}));
+    }
+    return result;
+}
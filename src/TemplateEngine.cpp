@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <set>
+
+#include "TemplateEngine.hpp"
+
+#include "utils/Exception.hpp"
+#include "utils/FileUtils.h"
+#include "utils/StringUtils.h"
+
+static bool isVariableChar(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+void TemplateEngine::Template::parse(std::string text)
+{
+    m_text.swap(text);
+    m_tokens.clear();
+    m_literalSize = 0;
+
+    // %%NAME%% with NAME of A-Z, 0-9 and '_'; any other '%%', e.g. of a printf format, is literal
+    size_t literal_start = 0;
+    size_t pos = 0;
+    while ((pos = m_text.find("%%", pos)) != std::string::npos)
+    {
+        size_t name_end = pos + 2;
+        while (name_end < m_text.size() && isVariableChar(m_text[name_end]))
+        {
+            ++name_end;
+        }
+        if (name_end == pos + 2 || m_text.compare(name_end, 2, "%%") != 0)
+        {
+            ++pos;
+            continue;
+        }
+        if (pos > literal_start)
+        {
+            m_tokens.push_back({literal_start, pos - literal_start, false});
+            m_literalSize += pos - literal_start;
+        }
+        m_tokens.push_back({pos, name_end + 2 - pos, true});
+        pos = literal_start = name_end + 2;
+    }
+    if (m_text.size() > literal_start)
+    {
+        m_tokens.push_back({literal_start, m_text.size() - literal_start, false});
+        m_literalSize += m_text.size() - literal_start;
+    }
+}
+
+void TemplateEngine::Template::render(const Variables &variables, std::string &output) const
+{
+    // look every variable up once and size the output, then fill it in one pass
+    std::vector<const std::string *> values(m_tokens.size(), nullptr);
+    size_t size = m_literalSize;
+    for (size_t i = 0; i < m_tokens.size(); ++i)
+    {
+        const Token &token = m_tokens[i];
+        if (!token.variable)
+        {
+            continue;
+        }
+        Variables::const_iterator found = variables.find(m_text.substr(token.offset + 2, token.length - 4));
+        values[i] = found != variables.end() ? &found->second : nullptr;
+        size += values[i] != nullptr ? values[i]->size() : token.length;
+    }
+
+    output.clear();
+    output.reserve(size);
+    for (size_t i = 0; i < m_tokens.size(); ++i)
+    {
+        if (values[i] != nullptr)
+        {
+            output.append(*values[i]);
+        }
+        else
+        {
+            output.append(m_text, m_tokens[i].offset, m_tokens[i].length);
+        }
+    }
+}
+
+std::string TemplateEngine::Template::render(const Variables &variables) const
+{
+    std::string output;
+    render(variables, output);
+    return output;
+}
+
+const TemplateEngine::Template *TemplateEngine::load(const std::string &template_path)
+{
+    std::map<std::string, Template>::iterator found = m_templates.find(template_path);
+    if (found == m_templates.end())
+    {
+        std::string text;
+        FileUtils::getFileContents(template_path, text);
+        found = m_templates.insert(std::make_pair(template_path, Template())).first;
+        found->second.parse(std::move(text));
+    }
+    return found->second.empty() ? nullptr : &found->second;
+}
+
+bool TemplateEngine::renderFile(const std::string &template_path, const std::string &output_path, const Variables &variables)
+{
+    const Template *parsed = load(template_path);
+    return parsed != nullptr && FileUtils::writeFileContents(output_path, parsed->render(variables));
+}
+
+std::vector<std::string> TemplateEngine::renderTree(const std::string &template_dir, const std::string &output_dir, const Variables &variables)
+{
+    std::string root = FileUtils::buildFilePath(template_dir, "");
+    std::vector<std::string> files = FileUtils::getRecursiveFileEntries(root);
+    std::sort(files.begin(), files.end());
+
+    std::vector<std::string> written;
+    std::set<std::string> created_dirs;
+    for (const std::string &file : files)
+    {
+        if (FileUtils::isDirectory(file) || !StringUtils::startsWith(file, root))
+        {
+            continue;
+        }
+        Template relative_path;
+        relative_path.parse(file.substr(root.size()));
+        std::string relative = relative_path.render(variables);
+        bool render = StringUtils::endsWith(relative, ".in");
+        if (render)
+        {
+            relative.resize(relative.size() - 3);
+        }
+
+        std::string output_path = FileUtils::buildFilePath(output_dir, relative);
+        std::string dir_path = FileUtils::getDirPath(output_path);
+        if (created_dirs.insert(dir_path).second)
+        {
+            FileUtils::createDirectory(dir_path);
+        }
+
+        if (!render)
+        {
+            FileUtils::copyFile(file, output_path);
+        }
+        else if (FileUtils::getFileSize(file) == 0)
+        {
+            FileUtils::writeFileContents(output_path, "");
+        }
+        else if (!renderFile(file, output_path, variables))
+        {
+            throw FileAccessException(EXCEPTION_TAG + "Could not render \"" + file + "\" to \"" + output_path + "\"");
+        }
+        written.emplace_back(output_path);
+    }
+    return written;
+}
@@ -1,28 +1,84 @@
 #include <iostream>
+#include <algorithm>
 #include <cstring>
 #include <string>
 
+#include "utils/FileUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/SystemUtils.h"
 
 #include "CommandLineArgs.h"
+#include "CacheServer.hpp"
 #include "PackageTool.hpp"
 
 static void _printValidSubcmds()
 {
     printf("Available <subcommands>:\n");
-    printf("   %-8s  %s\n", "help", "Show help message.");
-    printf("   %-8s  %s\n", "create", "Create cmake projects.");
-    printf("   %-8s  %s\n", "build", "Build and install cmake projects.");
-    printf("   %-8s  %s\n", "clean", "Clean cmake projects only those install files and cache files.");
-    printf("   %-8s  %s\n", "delete", "Delete cmake projects all files (including 'src/' directory). Be careful!");
-    printf("   %-8s  %s\n", "list", "List cmake projects path info.");
-    printf("   %-8s  %s\n", "reset", "Reset cmake projects path info.");
-    printf("   %-8s  %s\n", "run", "Run a cmake project program.");
-    printf("   %-8s  %s\n", "attach", "Attach cmake projects to cmake_tool.");
-    printf("   %-8s  %s\n", "detach", "Detach cmake projects from cmake_tool.");
-    printf("   %-8s  %s\n", "tar", "Tar cmake_tool projects output to a compression package.");
-    printf("   %-8s  %s\n", "untar", "Untar a compression package output to cmake_tool projects.");
+    printf("   %-13s  %s\n", "help", "Show help message.");
+    printf("   %-13s  %s\n", "create", "Create cmake projects.");
+    printf("   %-13s  %s\n", "build", "Build and install cmake projects.");
+    printf("   %-13s  %s\n", "sync-sources", "Regenerate the explicit source lists (sources.cmake) of cmake projects.");
+    printf("   %-13s  %s\n", "pch-suggest", "Propose the headers of a cmake project worth precompiling (include/pch.hpp).");
+    printf("   %-13s  %s\n", "add-component", "Add a component (object library under 'src/<name>/') to a modular cmake project.");
+    printf("   %-13s  %s\n", "clean", "Clean cmake projects only those install files and cache files.");
+    printf("   %-13s  %s\n", "delete", "Delete cmake projects all files (including 'src/' directory). Be careful!");
+    printf("   %-13s  %s\n", "list", "List cmake projects path info.");
+    printf("   %-13s  %s\n", "stats", "Show CPU time, peak memory and I/O of the latest builds.");
+    printf("   %-13s  %s\n", "reset", "Reset cmake projects path info.");
+    printf("   %-13s  %s\n", "run", "Run a cmake project program.");
+    printf("   %-13s  %s\n", "attach", "Attach cmake projects to cmake_tool.");
+    printf("   %-13s  %s\n", "detach", "Detach cmake projects from cmake_tool.");
+    printf("   %-13s  %s\n", "tar", "Tar cmake_tool projects output to a compression package.");
+    printf("   %-13s  %s\n", "untar", "Untar a compression package output to cmake_tool projects.");
+    printf("   %-13s  %s\n", "cache-server", "Serve an artifact cache over HTTP for 'build --remote-cache'.");
+}
+
+static void _setBuildRoot(PackageTool &package_tool, const CommandLineArgs &args)
+{
+    // '--build-root' without a directory selects the default scratch root
+    std::string build_root = args.value("-br");
+    if (build_root == "enable")
+    {
+        build_root = BuildRoot::getDefaultRootDirectory();
+    }
+    else if (build_root.empty())
+    {
+        build_root = SystemUtils::getEnv("CMAKE_TOOL_BUILD_ROOT");
+    }
+    package_tool.setBuildRoot(build_root, BuildRoot::parseSize(SystemUtils::getEnv("CMAKE_TOOL_BUILD_ROOT_MIN_FREE")));
+}
+
+static std::string _getToolchainEnvironment(const std::string &toolchain)
+{
+    // 'gcc-12' -> gcc-12 / g++-12, 'clang-16' -> clang-16 / clang++-16
+    if (toolchain.empty())
+    {
+        return "";
+    }
+    std::string c_compiler = toolchain;
+    std::string cxx_compiler;
+    if (StringUtils::startsWith(toolchain, "gcc", true))
+    {
+        cxx_compiler = "g++" + toolchain.substr(3);
+    }
+    else if (StringUtils::startsWith(toolchain, "clang", true))
+    {
+        cxx_compiler = "clang++" + toolchain.substr(5);
+    }
+    else
+    {
+        std::cerr << "Error: unknown toolchain [" << toolchain << "], expected gcc[-VERSION] or clang[-VERSION]." << std::endl;
+        return "";
+    }
+
+    std::string c_path = SystemUtils::findExecutable(c_compiler);
+    std::string cxx_path = SystemUtils::findExecutable(cxx_compiler);
+    if (c_path.empty() || cxx_path.empty())
+    {
+        std::cerr << "Error: toolchain [" << toolchain << "] not found, need '" << c_compiler << "' and '" << cxx_compiler << "' in PATH." << std::endl;
+        return "";
+    }
+    return "CC=\"" + c_path + "\" CXX=\"" + cxx_path + "\"";
 }
 
 static void _printHelp()
@@ -55,20 +111,116 @@ int main(int argc, char **argv)
 
         std::ostringstream info;
         info << "type of packages." << std::endl;
-        info << "\t\tCPP - CMake C++ Package (Default)" << std::endl;
-        info << "\t\tC   - CMake C Package" << std::endl;
+        info << "\t\tCPP  - CMake C++ Package (Default)" << std::endl;
+        info << "\t\tC    - CMake C Package" << std::endl;
+        info << "\t\tLIB  - CMake C++ Library (hidden visibility, export header, <Name>Config.cmake)" << std::endl;
+        info << "\t\tCLIB - CMake C Library (hidden visibility, export header, <Name>Config.cmake)" << std::endl;
+        info << "\t\tRT   - CMake C++ Real-time Application (Xenomai POSIX skin or plain POSIX, SCHED_FIFO cyclic task)" << std::endl;
 
         CommandLineArgs create_args("cmake_tool create", argc, argv);
         create_args.addOption("--log", "-l", false, "log debug info to file.");
         create_args.addOption("--type", "-t", false, info.str());
+        create_args.addOption("--unity", "-u", false, "compile sources in unity batches of N files. [default N = 8]");
+        create_args.addOption("--layout", "-ly", false, "C++ only: 'single' sources in 'src/', or 'modular' with one object library per 'src/<component>/' linked into the executable, see 'cmake_tool add-component'. [default = single]");
+        create_args.addOption("--modules", "-m", false, "C++ only: C++20 named module skeleton ('src/<name>.cppm' and an importing main), needs CMake 3.28 and Ninja.");
+        create_args.addOption("--pch", "-pch", false, "C++ only: generate 'include/pch.hpp' with common STL headers and precompile it.");
+        create_args.addOption("--with-bench", "-wb", false, "generate 'bench/' with a self-contained microbenchmark harness, built as 'bin/<name>_bench'.");
+        create_args.addOption("--with-tracing", "-wt", false, "C++ only: generate the header-only tracer 'include/trace.hpp', TRACE_SCOPE() zones are written as Chrome trace JSON at exit.");
+        create_args.addOption("--std", "-std", false, "language standard of the package, e.g. 17 (C++: 11, 14, 17, 20, 23; C: 90, 99, 11, 17, 23). [default = C++11, C++20 with '--modules', C99]");
+        create_args.addOption("--template", "-tp", false, "render a custom template tree instead of the built-in one: a directory or a name of 'share/cmake_tool/templates/'. Files ending in '.in' are rendered without the suffix, %%PROJECT_NAME%%, %%IDENTIFIER%%, %%AUTHOR%%, %%DATE%%, %%YEAR%%, %%CXX_STANDARD%%, %%C_STANDARD%%, %%PROFILE%% ... are replaced in contents and paths.");
+        create_args.addOption("--profile", "-pf", false, "build profile of 'cmake_tool_profile.cmake': none, debug, release, native (-O3 -march=native), lto (native, IPO, -fno-plt) or fastbuild (split DWARF, mold/lld). [default = none]");
         create_args.prepare();
 
         // get enable log
         bool enable_log = create_args.exists("-l");
         package_tool.setLog(enable_log);
 
+        // get create options
+        CreateOptions create_options;
+        if (create_args.exists("-u"))
+        {
+            int batch_size = atoi(create_args.value("-u").c_str());
+            create_options.unity_batch_size = batch_size > 0 ? batch_size : 8;
+        }
+        create_options.pch = create_args.exists("-pch");
+        create_options.modules = create_args.exists("-m");
+        create_options.bench = create_args.exists("-wb");
+        create_options.tracing = create_args.exists("-wt");
+        if (create_args.exists("-ly"))
+        {
+            std::string layout = StringUtils::toLower(create_args.value("-ly"));
+            if (layout != "single" && layout != "modular")
+            {
+                printf("cmake_tool: error: Unknown layout \"%s\", use single or modular.\n", create_args.value("-ly").c_str());
+                return 1;
+            }
+            create_options.modular = layout == "modular";
+        }
+        if (create_options.modules && create_options.modular)
+        {
+            printf("cmake_tool: error: '--modules' and '--layout modular' exclude each other.\n");
+            return 1;
+        }
+        if (create_options.modules && create_options.pch)
+        {
+            printf("cmake_tool: error: '--pch' and '--modules' exclude each other, modules are already compiled once.\n");
+            return 1;
+        }
+        if (create_args.exists("-pf"))
+        {
+            create_options.profile = StringUtils::toLower(create_args.value("-pf"));
+            if (!PackageTool::isValidProfile(create_options.profile))
+            {
+                printf("cmake_tool: error: Unknown build profile \"%s\", use none, debug, release, native, lto or fastbuild.\n", create_args.value("-pf").c_str());
+                return 1;
+            }
+        }
+
         // get package type
         std::string package_type = create_args.value("-t");
+        if (create_args.exists("-std"))
+        {
+            bool c_package = StringUtils::equals(package_type, "C") || StringUtils::equals(package_type, "CLIB");
+            create_options.standard = create_args.value("-std");
+            std::vector<std::string> standards = c_package ? std::vector<std::string>{"90", "99", "11", "17", "23"}
+                                                           : std::vector<std::string>{"11", "14", "17", "20", "23"};
+            if (std::find(standards.begin(), standards.end(), create_options.standard) == standards.end())
+            {
+                printf("cmake_tool: error: Unknown %s standard \"%s\", use %s.\n", c_package ? "C" : "C++",
+                       create_options.standard.c_str(), StringUtils::join(standards, ", ").c_str());
+                return 1;
+            }
+            if (create_options.modules && create_options.standard != "20" && create_options.standard != "23")
+            {
+                printf("cmake_tool: error: '--modules' needs C++20 or later.\n");
+                return 1;
+            }
+        }
+        if (create_args.exists("-tp"))
+        {
+            create_options.template_dir = create_args.value("-tp");
+            if (create_options.template_dir.empty() || create_options.modules || create_options.modular)
+            {
+                printf("cmake_tool: error: '--template' needs a directory or a template name and excludes '--modules' and '--layout modular'.\n");
+                return 1;
+            }
+        }
+        package_tool.setCreateOptions(create_options);
+        if (create_options.modules && !package_type.empty() && !StringUtils::equals(package_type, "CPP"))
+        {
+            printf("cmake_tool: error: '--modules' is for C++ application packages only.\n");
+            return 1;
+        }
+        if (create_options.modular && !package_type.empty() && !StringUtils::equals(package_type, "CPP"))
+        {
+            printf("cmake_tool: error: '--layout modular' is for C++ application packages only.\n");
+            return 1;
+        }
+        if (create_options.tracing && (StringUtils::equals(package_type, "C") || StringUtils::equals(package_type, "CLIB")))
+        {
+            printf("cmake_tool: error: '--with-tracing' is for C++ packages only.\n");
+            return 1;
+        }
 
         // create packages
         for (const std::string &package_path : create_args.getPackagePaths())
@@ -88,7 +240,29 @@ int main(int argc, char **argv)
         CommandLineArgs build_args("cmake_tool build", argc, argv);
         build_args.addOption("--log", "-l", false, "log debug info to file.");
         build_args.addOption("--all", "-a", false, "build all packages of 'cmake_tool list'.");
+        build_args.addOption("--resume", "-rs", false, "continue the unfinished and failed packages of the last 'build -a'.");
+        build_args.addOption("--watch", "-w", false, "rebuild packages and their dependents whenever their sources change.");
         build_args.addOption("--force", "-f", false, "force build all same name packages.");
+        build_args.addOption("--build-root", "-br", false, "directory holding the build trees, no value = '~/.cache/cmake_tool/build'. [default = $CMAKE_TOOL_BUILD_ROOT or '<package>/build']");
+        build_args.addOption("--cache", "-c", false, "reuse installed files of unchanged packages from the artifact cache.");
+        build_args.addOption("--remote-cache", "-r", false, "URL of a remote artifact cache, implies '--cache'. [default = $CMAKE_TOOL_REMOTE_CACHE]");
+        build_args.addOption("--jobs", "-j", false, "compile jobs shared by all packages. [default = number of CPUs]");
+        build_args.addOption("--configure-jobs", "-cj", false, "packages configured in parallel with compiling. [default = 2]");
+        build_args.addOption("--build-jobs", "-bj", false, "packages compiled at the same time. [default = 1, or the number of configs]");
+        build_args.addOption("--configs", "-cf", false, "comma separated build types built side by side, e.g. 'Debug,Release', installed to '<package>/install/<config>'.");
+        build_args.addOption("--toolchains", "-tc", false, "comma separated compilers built side by side, e.g. 'gcc-12,clang-16', installed to '<package>/install/<toolchain>'.");
+        build_args.addOption("--bench", "-bm", false, "program of 'bin/' (quoted with its arguments) timed for every build variant afterwards.");
+        build_args.addOption("--bench-runs", "-bn", false, "timed runs of the '--bench' program per variant. [default = 10]");
+        build_args.addOption("--unity", "-u", false, "unity build in batches of N sources, 'OFF' turns it off again. [default N = 8]");
+        build_args.addOption("--pch", "-pch", false, "precompile 'include/pch.hpp' of C++ packages, 'OFF' turns it off again.");
+        build_args.addOption("--generator", "-g", false, "CMake generator of new build trees, e.g. 'Ninja'. [default = $CMAKE_GENERATOR, Ninja for C++20 modules]");
+        build_args.addOption("--profile", "-pf", false, "build profile kept in the build tree: none, debug, release, native (-O3 -march=native), lto (native, IPO, -fno-plt) or fastbuild (split DWARF, mold/lld).");
+        build_args.addOption("--pgo", "-pgo", false, "profile guided optimization: build instrumented, run the '--train' program, rebuild with its profiles. Profiles are reused until the sources change.");
+        build_args.addOption("--train", "-tr", false, "program of 'bin/' (quoted with its arguments) run to train '--pgo'.");
+        build_args.addOption("--priority", "-pr", false, "'background' (nice 19, idle I/O, holds back new packages under CPU or I/O pressure), 'normal' or 'high' (needs CAP_SYS_NICE). [default = normal]");
+        build_args.addOption("--cpus", "-cpu", false, "CPUs the whole build may run on, e.g. '0-3,6'.");
+        build_args.addOption("--max-pressure", "-mp", false, "PSI cpu and io 'some avg10' in percent above which background builds hold back new packages. [default = 20]");
+        build_args.addOption("--analyze-compile-time", "-ac", false, "also build with compile time traces into '<build>/analyze' and report the N most expensive headers, templates and sources. [default N = 10]");
         build_args.prepare();
 
         // get enable log
@@ -97,20 +271,266 @@ int main(int argc, char **argv)
         // get enable force
         bool enable_force = build_args.exists("-f");
         package_tool.setForce(enable_force);
+        // get build root
+        _setBuildRoot(package_tool, build_args);
+        // get artifact cache options
+        BuildOptions build_options;
+        build_options.use_cache = build_args.exists("-c");
+        build_options.remote_cache_url = build_args.value("-r");
+        if (build_options.remote_cache_url.empty())
+        {
+            build_options.remote_cache_url = SystemUtils::getEnv("CMAKE_TOOL_REMOTE_CACHE");
+        }
+        // get pipeline options
+        if (build_args.exists("-j"))
+        {
+            build_options.jobs = atoi(build_args.value("-j").c_str());
+        }
+        if (build_args.exists("-cj"))
+        {
+            build_options.configure_jobs = atoi(build_args.value("-cj").c_str());
+        }
+        // get build configs and toolchains, every toolchain builds every config
+        std::vector<std::string> configs;
+        for (const std::string &config : StringUtils::split(build_args.value("-cf"), ","))
+        {
+            if (!StringUtils::trimmed(config).empty())
+            {
+                configs.emplace_back(StringUtils::trimmed(config));
+            }
+        }
+        // toolchain name and its compiler environment, looked up once
+        std::vector<std::pair<std::string, std::string>> toolchains;
+        for (const std::string &toolchain : StringUtils::split(build_args.value("-tc"), ","))
+        {
+            std::string environment = _getToolchainEnvironment(StringUtils::trimmed(toolchain));
+            if (!environment.empty())
+            {
+                toolchains.emplace_back(StringUtils::trimmed(toolchain), environment);
+            }
+        }
+        if (toolchains.empty())
+        {
+            toolchains.emplace_back("", "");
+        }
+        for (const auto &toolchain : toolchains)
+        {
+            for (const std::string &config : configs.empty() ? std::vector<std::string>{""} : configs)
+            {
+                if (toolchain.first.empty() && config.empty())
+                {
+                    continue;
+                }
+                BuildVariant build_variant;
+                build_variant.name = toolchain.first.empty() ? config : (config.empty() ? toolchain.first : toolchain.first + "/" + config);
+                build_variant.environment = toolchain.second;
+                // toolchains are compared as optimized builds unless a config is given
+                build_variant.cmake_args.emplace_back("-DCMAKE_BUILD_TYPE=" + (config.empty() ? std::string("Release") : config));
+                build_options.variants.emplace_back(build_variant);
+            }
+        }
+        if (build_args.exists("-tc") && toolchains.front().first.empty())
+        {
+            return 1;
+        }
+        // get benchmark options
+        build_options.bench_program = build_args.value("-bm");
+        if (build_args.exists("-bn"))
+        {
+            build_options.bench_runs = std::max(2, atoi(build_args.value("-bn").c_str()));
+        }
+        // get unity build options, kept in the CMake cache of the build tree
+        if (build_args.exists("-u"))
+        {
+            std::string unity = build_args.value("-u");
+            if (StringUtils::equals(unity, "OFF"))
+            {
+                build_options.cmake_args.emplace_back("-DCMAKE_UNITY_BUILD=OFF");
+            }
+            else
+            {
+                int batch_size = atoi(unity.c_str());
+                build_options.cmake_args.emplace_back("-DCMAKE_UNITY_BUILD=ON");
+                build_options.cmake_args.emplace_back("-DCMAKE_UNITY_BUILD_BATCH_SIZE=" + std::to_string(batch_size > 0 ? batch_size : 8));
+            }
+        }
+        // get precompiled header option, kept in the CMake cache of the build tree
+        if (build_args.exists("-pch"))
+        {
+            build_options.cmake_args.emplace_back(StringUtils::equals(build_args.value("-pch"), "OFF") ? "-DTARGET_PCH=OFF" : "-DTARGET_PCH=ON");
+        }
+        // get generator of new build trees
+        build_options.generator = build_args.value("-g");
+        // get build profile, kept in the CMake cache of the build tree
+        if (build_args.exists("-pf"))
+        {
+            build_options.profile = StringUtils::toLower(build_args.value("-pf"));
+            if (!PackageTool::isValidProfile(build_options.profile))
+            {
+                printf("cmake_tool: error: Unknown build profile \"%s\", use none, debug, release, native, lto or fastbuild.\n", build_args.value("-pf").c_str());
+                return 1;
+            }
+            build_options.cmake_args.emplace_back("-DCMAKE_TOOL_PROFILE=" + build_options.profile);
+        }
+        // get profile guided optimization options
+        if (build_args.exists("-pgo"))
+        {
+            build_options.pgo_train = StringUtils::trimmed(build_args.value("-tr"));
+            if (build_options.pgo_train.empty())
+            {
+                printf("cmake_tool: error: '--pgo' needs a training program, e.g. --train \"PROGRAM ARGS\".\n");
+                return 1;
+            }
+            if (build_args.exists("-a") || build_args.exists("-rs") || build_args.exists("-w"))
+            {
+                printf("cmake_tool: error: '--pgo' builds the given packages only, it can not be combined with '--all', '--resume' or '--watch'.\n");
+                return 1;
+            }
+        }
+        // get compile time analysis options
+        if (build_args.exists("-ac"))
+        {
+            int top_count = atoi(build_args.value("-ac").c_str());
+            build_options.analyze_compile_time = top_count > 0 ? top_count : 10;
+        }
+        if (build_args.exists("-bj"))
+        {
+            build_options.build_jobs = atoi(build_args.value("-bj").c_str());
+        }
+        else if (build_options.variants.size() > 1)
+        {
+            build_options.build_jobs = build_options.variants.size();
+        }
+        build_options.native_install = SystemUtils::getEnv("CMAKE_TOOL_NATIVE_INSTALL") != "0";
+        build_options.prefetch = SystemUtils::getEnv("CMAKE_TOOL_PREFETCH") != "0";
+        // get priority options, applied before any child starts so the whole process tree inherits them
+        if (build_args.exists("-pr") && !BuildPriority::parse(build_args.value("-pr"), build_options.priority))
+        {
+            std::cerr << "Error: unknown priority [" << build_args.value("-pr") << "], expected background, normal or high." << std::endl;
+            return 1;
+        }
+        std::vector<int> cpus;
+        if (build_args.exists("-cpu") && !BuildPriority::parseCpuList(build_args.value("-cpu"), cpus))
+        {
+            std::cerr << "Error: invalid cpu list [" << build_args.value("-cpu") << "], expected e.g. '0-3,6'." << std::endl;
+            return 1;
+        }
+        if (build_args.exists("-mp"))
+        {
+            build_options.max_pressure = atof(build_args.value("-mp").c_str());
+        }
+        BuildPriority::apply(build_options.priority, cpus);
+        package_tool.setBuildOptions(build_options);
 
         // build packages
         if (build_args.exists("-a"))
         {
             package_tool.buildAllPackages();
         }
+        else if (build_args.exists("-rs"))
+        {
+            package_tool.resumeBuild();
+        }
+        else if (build_args.exists("-w"))
+        {
+            package_tool.watchPackages(build_args.getPackagePaths());
+        }
         else
         {
-            for (const std::string &package_path : build_args.getPackagePaths())
-            {
-                package_tool.buildPackage(package_path);
-            }
+            package_tool.buildPackages(build_args.getPackagePaths());
+        }
+    }
+    else if (0 == strcmp(argv[0], "sync-sources"))
+    {
+        if (argc < 2)
+        {
+            printf("cmake_tool: error: You must specify at least one package name.\n");
+            printf("\nUsage: cmake_tool sync-sources PACKAGE1 [PACKAGE2 ...] [options]\nIf you need more help, please add option \"-h\".\n");
+            return 0;
+        }
+
+        CommandLineArgs sync_args("cmake_tool sync-sources", argc, argv);
+        sync_args.addOption("--log", "-l", false, "log debug info to file.");
+        sync_args.addOption("--all", "-a", false, "sync all packages of 'cmake_tool list'.");
+        sync_args.addOption("--force", "-f", false, "force sync all same name packages.");
+        sync_args.prepare();
+
+        // get enable log
+        bool enable_log = sync_args.exists("-l");
+        package_tool.setLog(enable_log);
+        // get enable force
+        bool enable_force = sync_args.exists("-f");
+        package_tool.setForce(enable_force);
+
+        // sync packages
+        if (sync_args.exists("-a"))
+        {
+            package_tool.syncAllSources();
+        }
+        else
+        {
+            package_tool.syncSources(sync_args.getPackagePaths());
+        }
+    }
+    else if (0 == strcmp(argv[0], "pch-suggest"))
+    {
+        if (argc < 2)
+        {
+            printf("cmake_tool: error: You must specify a package name.\n");
+            printf("\nUsage: cmake_tool pch-suggest PACKAGE [options]\nIf you need more help, please add option \"-h\".\n");
+            return 0;
+        }
+
+        CommandLineArgs pch_args("cmake_tool pch-suggest", argc, argv);
+        pch_args.addOption("--log", "-l", false, "log debug info to file.");
+        pch_args.addOption("--top", "-n", false, "propose at most N headers. [default = 20]");
+        pch_args.addOption("--write", "-w", false, "write the proposal to 'include/pch.hpp'.");
+        pch_args.addOption("--force", "-f", false, "scan all same name packages.");
+        pch_args.prepare();
+
+        // get enable log
+        bool enable_log = pch_args.exists("-l");
+        package_tool.setLog(enable_log);
+        // get enable force
+        bool enable_force = pch_args.exists("-f");
+        package_tool.setForce(enable_force);
+
+        int max_count = pch_args.exists("-n") ? atoi(pch_args.value("-n").c_str()) : 20;
+        for (const std::string &package_path : pch_args.getPackagePaths())
+        {
+            package_tool.suggestPch(package_path, max_count > 0 ? max_count : 20, pch_args.exists("-w"));
         }
     }
+    else if (0 == strcmp(argv[0], "add-component"))
+    {
+        if (argc < 3)
+        {
+            printf("cmake_tool: error: You must specify a package name and a component name.\n");
+            printf("\nUsage: cmake_tool add-component PACKAGE NAME [options]\nIf you need more help, please add option \"-h\".\n");
+            return 0;
+        }
+
+        CommandLineArgs component_args("cmake_tool add-component", argc, argv);
+        component_args.addOption("--log", "-l", false, "log debug info to file.");
+        component_args.addOption("--force", "-f", false, "resolve the package among all same name packages.");
+        component_args.prepare();
+
+        // get enable log
+        bool enable_log = component_args.exists("-l");
+        package_tool.setLog(enable_log);
+        // get enable force
+        bool enable_force = component_args.exists("-f");
+        package_tool.setForce(enable_force);
+
+        const std::vector<std::string> &args = component_args.getPackagePaths();
+        if (args.size() != 2)
+        {
+            printf("cmake_tool: error: You must specify a package name and a component name.\n");
+            printf("\nUsage: cmake_tool add-component PACKAGE NAME [options]\nIf you need more help, please add option \"-h\".\n");
+            return 1;
+        }
+        package_tool.addComponent(args[0], args[1]);
+    }
     else if (0 == strcmp(argv[0], "clean"))
     {
         if (argc < 2)
@@ -124,6 +544,7 @@ int main(int argc, char **argv)
         clean_args.addOption("--log", "-l", false, "log debug info to file.");
         clean_args.addOption("--all", "-a", false, "clean all packages of 'cmake_tool list'.");
         clean_args.addOption("--force", "-f", false, "force clean all same name packages.");
+        clean_args.addOption("--build-root", "-br", false, "directory holding the build trees, no value = '~/.cache/cmake_tool/build'. [default = $CMAKE_TOOL_BUILD_ROOT or '<package>/build']");
         clean_args.prepare();
 
         // get enable log
@@ -132,6 +553,8 @@ int main(int argc, char **argv)
         // get enable force
         bool enable_force = clean_args.exists("-f");
         package_tool.setForce(enable_force);
+        // get build root
+        _setBuildRoot(package_tool, clean_args);
 
         // clean packages
         if (clean_args.exists("-a"))
@@ -159,6 +582,7 @@ int main(int argc, char **argv)
         delete_args.addOption("--log", "-l", false, "log debug info to file.");
         delete_args.addOption("--all", "-a", false, "delete all packages of 'cmake_tool list'.");
         delete_args.addOption("--force", "-f", false, "force delete all same name packages.");
+        delete_args.addOption("--build-root", "-br", false, "directory holding the build trees, no value = '~/.cache/cmake_tool/build'. [default = $CMAKE_TOOL_BUILD_ROOT or '<package>/build']");
         delete_args.prepare();
 
         // get enable log
@@ -167,6 +591,8 @@ int main(int argc, char **argv)
         // get enable force
         bool enable_force = delete_args.exists("-f");
         package_tool.setForce(enable_force);
+        // get build root
+        _setBuildRoot(package_tool, delete_args);
 
         // delete packages
         if (delete_args.exists("-a"))
@@ -198,6 +624,25 @@ int main(int argc, char **argv)
         bool path_only = list_args.exists("-p");
         package_tool.listPackages(basename_only, path_only);
     }
+    else if (0 == strcmp(argv[0], "stats"))
+    {
+        CommandLineArgs stats_args("cmake_tool stats", argc, argv);
+        stats_args.addOption("--log", "-l", false, "log debug info to file.");
+        stats_args.addOption("--sort", "-s", false, "sort by 'cpu', 'rss', 'time' or 'io'. [default = cpu]");
+        stats_args.addOption("--stages", "-st", false, "show the configure, build and install stages of every build.");
+        stats_args.addOption("--force", "-f", false, "show all same name packages.");
+        stats_args.prepare();
+
+        // get enable log
+        bool enable_log = stats_args.exists("-l");
+        package_tool.setLog(enable_log);
+        // get enable force
+        bool enable_force = stats_args.exists("-f");
+        package_tool.setForce(enable_force);
+
+        // show stats of the given packages, or of all built packages
+        package_tool.showStats(stats_args.getPackagePaths(), stats_args.value("-s"), stats_args.exists("-st"));
+    }
     else if (0 == strcmp(argv[0], "reset"))
     {
         CommandLineArgs reset_args("cmake_tool reset", argc, argv);
@@ -216,10 +661,19 @@ int main(int argc, char **argv)
         if (argc < 3)
         {
             printf("cmake_tool: error: You must specify a package name and a program name.\n");
-            printf("\nUsage: cmake_tool run PACKAGE PROGRAM [program options].\n");
+            printf("\nUsage: cmake_tool run [--config CONFIG] PACKAGE PROGRAM [program options].\n");
             return 0;
         }
 
+        // get build config, only before the package, everything after the program belongs to it
+        std::string config;
+        if (argc >= 5 && (0 == strcmp(argv[1], "--config") || 0 == strcmp(argv[1], "-cf")))
+        {
+            config = std::string(argv[2]);
+            argv += 2;
+            argc -= 2;
+        }
+
         std::string package_path = std::string(argv[1]);
         std::string program_name = std::string(argv[2]);
         std::vector<std::string> program_args;
@@ -229,7 +683,7 @@ int main(int argc, char **argv)
         }
 
         // run a package
-        package_tool.runPackage(package_path, program_name, program_args);
+        package_tool.runPackage(package_path, program_name, program_args, config);
     }
     else if (0 == strcmp(argv[0], "attach"))
     {
@@ -375,6 +829,29 @@ int main(int argc, char **argv)
             }
         }
     }
+    else if (0 == strcmp(argv[0], "cache-server"))
+    {
+        CommandLineArgs server_args("cmake_tool cache-server", argc, argv);
+        server_args.addOption("--port", "-p", false, "port to listen on. [default = 8080]");
+        server_args.addOption("--bind", "-b", false, "address to bind. [default = 127.0.0.1]");
+        server_args.addOption("--dir", "-d", false, "storage directory. [default = ~/.cache/cmake_tool/server]");
+        server_args.prepare();
+
+        int port = server_args.exists("-p") ? atoi(server_args.value("-p").c_str()) : 8080;
+        std::string bind_address = server_args.exists("-b") ? server_args.value("-b") : "127.0.0.1";
+        std::string storage_dir = server_args.value("-d");
+        if (storage_dir.empty())
+        {
+            storage_dir = FileUtils::buildFilePath(SystemUtils::getUserHomeDirectory(), ".cache/cmake_tool/server");
+        }
+
+        // serve until killed
+        CacheServer cache_server(FileUtils::getAbsolutePath(storage_dir), bind_address, port);
+        if (!cache_server.run())
+        {
+            return -1;
+        }
+    }
     else
     {
         printf("Invalid command, please check.\n\n");
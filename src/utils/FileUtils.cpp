@@ -4,6 +4,8 @@
 #include "utils/DateTimeUtils.hpp"
 #include "utils/Exception.hpp"
 
+#include <iterator>
+
 #ifdef _WIN32
 #include <windows.h>
 #include <shlobj.h>
@@ -90,7 +92,7 @@ bool FileUtils::getFileLines(const std::string &input_path_string,
     {
         return false;
     }
-    std::fstream in(input_path_string.c_str());
+    std::ifstream in(input_path_string.c_str());
     std::string line;
     bool hasData = false;
     while (in)
@@ -110,18 +112,27 @@ bool FileUtils::getFileLines(const std::string &input_path_string,
 
 void FileUtils::getFileContents(const std::string &input_path_string, std::string &output_file_data)
 {
-    std::fstream in(input_path_string.c_str(), std::ios::in);
+    std::ifstream in(input_path_string.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+    {
+        return;
+    }
 
-    while (in)
+    // one read of the whole file when its size is known, e.g. not for a pipe
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    if (size > 0)
     {
-        char c = (static_cast<char>(in.get()));
-        if (!in)
-        {
-            break;
-        }
-        output_file_data.push_back(c);
+        size_t offset = output_file_data.size();
+        output_file_data.resize(offset + static_cast<size_t>(size));
+        in.seekg(0, std::ios::beg);
+        in.read(&output_file_data[offset], size);
+        output_file_data.resize(offset + static_cast<size_t>(in.gcount()));
+        return;
     }
-    in.close();
+    in.clear();
+    in.seekg(0, std::ios::beg);
+    output_file_data.append(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
 }
 
 std::vector<std::string> FileUtils::getFileLines(const std::string &input_path_string)
@@ -461,10 +472,12 @@ bool FileUtils::createDirectory(const std::string &dirPath)
     CreateDirectoryA(dirPath.c_str(), NULL);
     // int nError = GetLastError();
 #else
-    // mkdir(dirPath.c_str(), 0733);
-    std::string cmd = "mkdir -p " + dirPath;
-    pid_t status = system(cmd.c_str());
-    (void)status;
+    // mkdir -p without a shell per directory, every missing parent first
+    for (size_t pos = dirPath.find('/', 1); pos != std::string::npos; pos = dirPath.find('/', pos + 1))
+    {
+        mkdir(dirPath.substr(0, pos).c_str(), 0777);
+    }
+    mkdir(dirPath.c_str(), 0777);
 #endif
     return isDirectory(dirPath);
 }
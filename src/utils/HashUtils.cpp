@@ -0,0 +1,181 @@
+#include "utils/HashUtils.h"
+
+#include <cstdio>
+
+static const std::uint32_t s_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static inline std::uint32_t _rotr(std::uint32_t x, std::uint32_t n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+HashUtils::Sha256::Sha256()
+{
+    m_state[0] = 0x6a09e667;
+    m_state[1] = 0xbb67ae85;
+    m_state[2] = 0x3c6ef372;
+    m_state[3] = 0xa54ff53a;
+    m_state[4] = 0x510e527f;
+    m_state[5] = 0x9b05688c;
+    m_state[6] = 0x1f83d9ab;
+    m_state[7] = 0x5be0cd19;
+}
+
+void HashUtils::Sha256::_transform(const std::uint8_t *block)
+{
+    std::uint32_t w[64];
+    for (int i = 0; i < 16; ++i)
+    {
+        w[i] = (static_cast<std::uint32_t>(block[i * 4]) << 24) |
+               (static_cast<std::uint32_t>(block[i * 4 + 1]) << 16) |
+               (static_cast<std::uint32_t>(block[i * 4 + 2]) << 8) |
+               (static_cast<std::uint32_t>(block[i * 4 + 3]));
+    }
+    for (int i = 16; i < 64; ++i)
+    {
+        std::uint32_t s0 = _rotr(w[i - 15], 7) ^ _rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        std::uint32_t s1 = _rotr(w[i - 2], 17) ^ _rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    std::uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+    std::uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+    for (int i = 0; i < 64; ++i)
+    {
+        std::uint32_t s1 = _rotr(e, 6) ^ _rotr(e, 11) ^ _rotr(e, 25);
+        std::uint32_t ch = (e & f) ^ (~e & g);
+        std::uint32_t t1 = h + s1 + ch + s_sha256_k[i] + w[i];
+        std::uint32_t s0 = _rotr(a, 2) ^ _rotr(a, 13) ^ _rotr(a, 22);
+        std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        std::uint32_t t2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    m_state[0] += a;
+    m_state[1] += b;
+    m_state[2] += c;
+    m_state[3] += d;
+    m_state[4] += e;
+    m_state[5] += f;
+    m_state[6] += g;
+    m_state[7] += h;
+}
+
+void HashUtils::Sha256::update(const void *data, size_t size)
+{
+    const std::uint8_t *bytes = static_cast<const std::uint8_t *>(data);
+    m_length += size;
+
+    if (m_buffer_size > 0)
+    {
+        while (size > 0 && m_buffer_size < sizeof(m_buffer))
+        {
+            m_buffer[m_buffer_size++] = *bytes++;
+            --size;
+        }
+        if (m_buffer_size == sizeof(m_buffer))
+        {
+            _transform(m_buffer);
+            m_buffer_size = 0;
+        }
+    }
+
+    while (size >= sizeof(m_buffer))
+    {
+        _transform(bytes);
+        bytes += sizeof(m_buffer);
+        size -= sizeof(m_buffer);
+    }
+
+    while (size > 0)
+    {
+        m_buffer[m_buffer_size++] = *bytes++;
+        --size;
+    }
+}
+
+void HashUtils::Sha256::update(const std::string &data)
+{
+    update(data.data(), data.size());
+}
+
+std::string HashUtils::Sha256::hexDigest()
+{
+    std::uint64_t bit_length = m_length * 8;
+    std::uint8_t padding[72] = {0x80};
+    size_t padding_size = (m_buffer_size < 56) ? (56 - m_buffer_size) : (120 - m_buffer_size);
+    for (int i = 0; i < 8; ++i)
+    {
+        padding[padding_size + i] = static_cast<std::uint8_t>(bit_length >> (56 - i * 8));
+    }
+    update(padding, padding_size + 8);
+
+    static const char hex_chars[] = "0123456789abcdef";
+    std::string digest;
+    digest.reserve(64);
+    for (int i = 0; i < 8; ++i)
+    {
+        for (int shift = 28; shift >= 0; shift -= 4)
+        {
+            digest.push_back(hex_chars[(m_state[i] >> shift) & 0xf]);
+        }
+    }
+    return digest;
+}
+
+std::string HashUtils::sha256(const std::string &data)
+{
+    Sha256 hasher;
+    hasher.update(data);
+    return hasher.hexDigest();
+}
+
+std::string HashUtils::sha256File(const std::string &input_path_string)
+{
+    FILE *file = fopen(input_path_string.c_str(), "rb");
+    if (!file)
+    {
+        return "";
+    }
+
+    Sha256 hasher;
+    char buffer[65536];
+    size_t bytes_read = 0;
+    while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        hasher.update(buffer, bytes_read);
+    }
+    fclose(file);
+    return hasher.hexDigest();
+}
+
+bool HashUtils::isHexDigest(const std::string &input_string)
+{
+    if (input_string.size() != 64)
+    {
+        return false;
+    }
+    for (char c : input_string)
+    {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+        {
+            return false;
+        }
+    }
+    return true;
+}
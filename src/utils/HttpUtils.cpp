@@ -0,0 +1,353 @@
+#include "utils/HttpUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/FileUtils.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+static const int s_client_timeout_seconds = 60;
+
+bool HttpUtils::parseUrl(const std::string &url, Url &output_url)
+{
+    const std::string scheme = "http://";
+    if (!StringUtils::startsWith(url, scheme))
+    {
+        return false;
+    }
+
+    std::string rest = url.substr(scheme.size());
+    size_t path_pos = rest.find('/');
+    std::string authority = rest.substr(0, path_pos);
+    output_url.path = (path_pos == std::string::npos) ? "/" : rest.substr(path_pos);
+
+    size_t port_pos = authority.rfind(':');
+    if (port_pos != std::string::npos)
+    {
+        output_url.host = authority.substr(0, port_pos);
+        output_url.port = authority.substr(port_pos + 1);
+    }
+    else
+    {
+        output_url.host = authority;
+        output_url.port = "80";
+    }
+    return !output_url.host.empty() && !output_url.port.empty();
+}
+
+int HttpUtils::connectTo(const std::string &host, const std::string &port)
+{
+    struct addrinfo hints;
+    struct addrinfo *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0)
+    {
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *addr = result; addr != NULL; addr = addr->ai_next)
+    {
+        fd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (connect(fd, addr->ai_addr, addr->ai_addrlen) == 0)
+        {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+
+    if (fd >= 0)
+    {
+        setTimeout(fd, s_client_timeout_seconds);
+    }
+    return fd;
+}
+
+int HttpUtils::listenOn(const std::string &bind_address, int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1 ||
+        bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, 64) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void HttpUtils::setTimeout(int fd, int seconds)
+{
+    struct timeval tv;
+    tv.tv_sec = seconds;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+bool HttpUtils::sendAll(int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            if (sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool HttpUtils::readHeaders(int fd, std::string &output_headers, std::string &output_body_prefix)
+{
+    std::string data;
+    char buffer[4096];
+    while (true)
+    {
+        size_t end_pos = data.find("\r\n\r\n");
+        if (end_pos != std::string::npos)
+        {
+            output_headers = data.substr(0, end_pos);
+            output_body_prefix = data.substr(end_pos + 4);
+            return true;
+        }
+        if (data.size() > 64 * 1024)
+        {
+            return false;
+        }
+
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data.append(buffer, static_cast<size_t>(received));
+    }
+}
+
+std::string HttpUtils::headerValue(const std::string &headers, const std::string &name)
+{
+    for (const std::string &line : StringUtils::split(headers, "\r\n"))
+    {
+        size_t colon_pos = line.find(':');
+        if (colon_pos == std::string::npos)
+        {
+            continue;
+        }
+        if (StringUtils::equals(StringUtils::trimmed(line.substr(0, colon_pos)), name))
+        {
+            return StringUtils::trimmed(line.substr(colon_pos + 1));
+        }
+    }
+    return "";
+}
+
+// Sends one request and reads the response. The request body comes either from
+// memory (body) or from a file (body_file); the response body goes either to
+// memory (output_body) or to a file (output_file).
+static int _request(const std::string &method,
+                    const std::string &url,
+                    const std::string *body,
+                    FILE *body_file,
+                    std::uint64_t body_file_size,
+                    std::string *output_body,
+                    FILE *output_file)
+{
+    HttpUtils::Url parsed_url;
+    if (!HttpUtils::parseUrl(url, parsed_url))
+    {
+        return -1;
+    }
+
+    int fd = HttpUtils::connectTo(parsed_url.host, parsed_url.port);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    std::uint64_t content_length = body ? body->size() : body_file_size;
+    std::string request = method + " " + parsed_url.path + " HTTP/1.1\r\n" +
+                          "Host: " + parsed_url.host + ":" + parsed_url.port + "\r\n" +
+                          "User-Agent: cmake_tool\r\n" +
+                          "Connection: close\r\n";
+    if (body || body_file)
+    {
+        request += "Content-Type: application/octet-stream\r\n";
+        request += "Content-Length: " + std::to_string(content_length) + "\r\n";
+    }
+    request += "\r\n";
+
+    bool ok = HttpUtils::sendAll(fd, request.data(), request.size());
+    if (ok && body)
+    {
+        ok = HttpUtils::sendAll(fd, body->data(), body->size());
+    }
+    if (ok && body_file)
+    {
+        char buffer[65536];
+        size_t bytes_read = 0;
+        while (ok && (bytes_read = fread(buffer, 1, sizeof(buffer), body_file)) > 0)
+        {
+            ok = HttpUtils::sendAll(fd, buffer, bytes_read);
+        }
+    }
+
+    std::string headers;
+    std::string body_prefix;
+    if (!ok || !HttpUtils::readHeaders(fd, headers, body_prefix))
+    {
+        close(fd);
+        return -1;
+    }
+
+    // status line: HTTP/1.1 200 OK
+    int status = -1;
+    size_t space_pos = headers.find(' ');
+    if (space_pos != std::string::npos)
+    {
+        status = atoi(headers.c_str() + space_pos + 1);
+    }
+
+    if (method == "HEAD")
+    {
+        close(fd);
+        return status;
+    }
+
+    std::string length_value = HttpUtils::headerValue(headers, "Content-Length");
+    bool has_length = !length_value.empty();
+    std::uint64_t remaining = has_length ? strtoull(length_value.c_str(), NULL, 10) : 0;
+
+    auto consume = [&](const char *data, size_t size) -> bool {
+        if (output_body)
+        {
+            output_body->append(data, size);
+        }
+        if (output_file)
+        {
+            return fwrite(data, 1, size, output_file) == size;
+        }
+        return true;
+    };
+
+    size_t prefix_size = body_prefix.size();
+    if (has_length && prefix_size > remaining)
+    {
+        prefix_size = static_cast<size_t>(remaining);
+    }
+    ok = consume(body_prefix.data(), prefix_size);
+    remaining -= has_length ? prefix_size : 0;
+
+    char buffer[65536];
+    while (ok && (!has_length || remaining > 0))
+    {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            // a short body is only acceptable when the server did not announce a length
+            ok = !has_length;
+            break;
+        }
+        size_t chunk = static_cast<size_t>(received);
+        if (has_length && chunk > remaining)
+        {
+            chunk = static_cast<size_t>(remaining);
+        }
+        ok = consume(buffer, chunk);
+        remaining -= has_length ? chunk : 0;
+    }
+    close(fd);
+
+    return ok ? status : -1;
+}
+
+int HttpUtils::get(const std::string &url, std::string &output_body)
+{
+    output_body.clear();
+    return _request("GET", url, NULL, NULL, 0, &output_body, NULL);
+}
+
+int HttpUtils::getToFile(const std::string &url, const std::string &output_path)
+{
+    FILE *file = fopen(output_path.c_str(), "wb");
+    if (!file)
+    {
+        return -1;
+    }
+    int status = _request("GET", url, NULL, NULL, 0, NULL, file);
+    if (fclose(file) != 0)
+    {
+        status = -1;
+    }
+    if (status != 200)
+    {
+        remove(output_path.c_str());
+    }
+    return status;
+}
+
+int HttpUtils::head(const std::string &url)
+{
+    return _request("HEAD", url, NULL, NULL, 0, NULL, NULL);
+}
+
+int HttpUtils::put(const std::string &url, const std::string &body)
+{
+    return _request("PUT", url, &body, NULL, 0, NULL, NULL);
+}
+
+int HttpUtils::putFile(const std::string &url, const std::string &input_path)
+{
+    FILE *file = fopen(input_path.c_str(), "rb");
+    if (!file)
+    {
+        return -1;
+    }
+    int status = _request("PUT", url, NULL, file, FileUtils::getFileSize(input_path), NULL, NULL);
+    fclose(file);
+    return status;
+}
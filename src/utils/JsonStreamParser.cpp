@@ -0,0 +1,279 @@
+#include <cctype>
+
+#include "utils/JsonStreamParser.h"
+
+JsonStreamParser::JsonStreamParser()
+{
+}
+
+JsonStreamParser::~JsonStreamParser()
+{
+    if (m_file != nullptr)
+    {
+        fclose(m_file);
+    }
+}
+
+bool JsonStreamParser::open(const std::string &input_path_string)
+{
+    if (m_file != nullptr)
+    {
+        fclose(m_file);
+    }
+    m_file = fopen(input_path_string.c_str(), "rb");
+    m_pos = m_size = 0;
+    m_stack.clear();
+    m_expectKey = false;
+    return m_file != nullptr;
+}
+
+int JsonStreamParser::_peek()
+{
+    if (m_pos == m_size)
+    {
+        if (m_file == nullptr)
+        {
+            return EOF;
+        }
+        m_size = fread(m_buffer, 1, sizeof(m_buffer), m_file);
+        m_pos = 0;
+        if (m_size == 0)
+        {
+            return EOF;
+        }
+    }
+    return static_cast<unsigned char>(m_buffer[m_pos]);
+}
+
+int JsonStreamParser::_get()
+{
+    int c = _peek();
+    if (c != EOF)
+    {
+        ++m_pos;
+    }
+    return c;
+}
+
+void JsonStreamParser::_skipWhitespace()
+{
+    while (isspace(_peek()))
+    {
+        _get();
+    }
+}
+
+void JsonStreamParser::_endValue()
+{
+    m_expectKey = !m_stack.empty() && m_stack.back() == '{';
+}
+
+static void _appendUtf8(std::string &output_string, unsigned code_point)
+{
+    if (code_point < 0x80)
+    {
+        output_string += static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        output_string += static_cast<char>(0xC0 | (code_point >> 6));
+        output_string += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000)
+    {
+        output_string += static_cast<char>(0xE0 | (code_point >> 12));
+        output_string += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        output_string += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        output_string += static_cast<char>(0xF0 | (code_point >> 18));
+        output_string += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        output_string += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        output_string += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+bool JsonStreamParser::_readString(std::string &output_string)
+{
+    output_string.clear();
+    if (_get() != '"')
+    {
+        return false;
+    }
+
+    unsigned high_surrogate = 0;
+    while (true)
+    {
+        int c = _get();
+        if (c == EOF)
+        {
+            return false;
+        }
+        if (c == '"')
+        {
+            return true;
+        }
+        if (c != '\\')
+        {
+            output_string += static_cast<char>(c);
+            continue;
+        }
+
+        c = _get();
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            output_string += static_cast<char>(c);
+            break;
+        case 'b':
+            output_string += '\b';
+            break;
+        case 'f':
+            output_string += '\f';
+            break;
+        case 'n':
+            output_string += '\n';
+            break;
+        case 'r':
+            output_string += '\r';
+            break;
+        case 't':
+            output_string += '\t';
+            break;
+        case 'u':
+        {
+            unsigned code_point = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                int h = _get();
+                if (!isxdigit(h))
+                {
+                    return false;
+                }
+                code_point = code_point * 16 + (isdigit(h) ? h - '0' : (tolower(h) - 'a' + 10));
+            }
+            if (code_point >= 0xD800 && code_point < 0xDC00)
+            {
+                high_surrogate = code_point;
+                continue;
+            }
+            if (code_point >= 0xDC00 && code_point < 0xE000 && high_surrogate != 0)
+            {
+                code_point = 0x10000 + ((high_surrogate - 0xD800) << 10) + (code_point - 0xDC00);
+            }
+            _appendUtf8(output_string, code_point);
+            break;
+        }
+        default:
+            return false;
+        }
+        high_surrogate = 0;
+    }
+}
+
+JsonStreamParser::Token JsonStreamParser::next()
+{
+    _skipWhitespace();
+    int c = _peek();
+    if (c == ',')
+    {
+        _get();
+        _skipWhitespace();
+        c = _peek();
+    }
+
+    if (c == EOF)
+    {
+        return m_stack.empty() ? Token::END : Token::ERROR;
+    }
+
+    if (c == '}' || c == ']')
+    {
+        if (m_stack.empty() || m_stack.back() != (c == '}' ? '{' : '['))
+        {
+            return Token::ERROR;
+        }
+        _get();
+        m_stack.pop_back();
+        _endValue();
+        return c == '}' ? Token::OBJECT_END : Token::ARRAY_END;
+    }
+
+    if (m_expectKey)
+    {
+        if (!_readString(m_value))
+        {
+            return Token::ERROR;
+        }
+        _skipWhitespace();
+        if (_get() != ':')
+        {
+            return Token::ERROR;
+        }
+        m_expectKey = false;
+        return Token::KEY;
+    }
+
+    switch (c)
+    {
+    case '{':
+        _get();
+        m_stack.push_back('{');
+        m_expectKey = true;
+        return Token::OBJECT_BEGIN;
+    case '[':
+        _get();
+        m_stack.push_back('[');
+        m_expectKey = false;
+        return Token::ARRAY_BEGIN;
+    case '"':
+        if (!_readString(m_value))
+        {
+            return Token::ERROR;
+        }
+        _endValue();
+        return Token::STRING;
+    default:
+        break;
+    }
+
+    m_value.clear();
+    if (c == '-' || isdigit(c))
+    {
+        while (c != EOF && (isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'))
+        {
+            m_value += static_cast<char>(_get());
+            c = _peek();
+        }
+        _endValue();
+        return Token::NUMBER;
+    }
+    while (c != EOF && isalpha(c))
+    {
+        m_value += static_cast<char>(_get());
+        c = _peek();
+    }
+    _endValue();
+    if (m_value == "true" || m_value == "false")
+    {
+        return Token::BOOLEAN;
+    }
+    return m_value == "null" ? Token::NULL_VALUE : Token::ERROR;
+}
+
+bool JsonStreamParser::skipValue()
+{
+    size_t start_depth = depth();
+    do
+    {
+        Token token = next();
+        if (token == Token::ERROR || token == Token::END)
+        {
+            return false;
+        }
+    } while (depth() > start_depth);
+    return true;
+}
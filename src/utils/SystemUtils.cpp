@@ -4,6 +4,11 @@
 
 #include "external/tiny-process-library/process.hpp"
 
+#ifndef _WIN32
+    #include <sys/resource.h>
+    #include <sys/wait.h>
+#endif
+
 
 std::string SystemUtils::getUserHomeDirectory()
 {
@@ -141,6 +146,100 @@ int SystemUtils::execute(const std::string &command)
     return process.get_exit_status();
 }
 
+int SystemUtils::executeShell(const std::string &command, const std::string &output_path, ProcessUsage *usage)
+{
+#ifdef _WIN32
+    (void)output_path;
+    (void)usage;
+    return system(command.c_str());
+#else
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        return -1;
+    }
+    if (pid == 0)
+    {
+        if (!output_path.empty())
+        {
+            int fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            if (fd >= 0)
+            {
+                dup2(fd, STDOUT_FILENO);
+                dup2(fd, STDERR_FILENO);
+                close(fd);
+            }
+            int null_fd = open("/dev/null", O_RDONLY);
+            if (null_fd >= 0)
+            {
+                dup2(null_fd, STDIN_FILENO);
+                close(null_fd);
+            }
+        }
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char *>(NULL));
+        _exit(127);
+    }
+
+    // wait4 reports this child only, unlike getrusage(RUSAGE_CHILDREN) which
+    // mixes in the children other threads are waiting for
+    int status = 0;
+    struct rusage child_usage;
+    while (wait4(pid, &status, 0, &child_usage) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
+    if (usage != nullptr)
+    {
+        ProcessUsage process_usage;
+        process_usage.user_seconds = child_usage.ru_utime.tv_sec + child_usage.ru_utime.tv_usec / 1e6;
+        process_usage.system_seconds = child_usage.ru_stime.tv_sec + child_usage.ru_stime.tv_usec / 1e6;
+        process_usage.max_rss_kb = child_usage.ru_maxrss;
+        process_usage.block_input = child_usage.ru_inblock;
+        process_usage.block_output = child_usage.ru_oublock;
+        usage->add(process_usage);
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+std::string SystemUtils::findExecutable(const std::string &program_name)
+{
+    if (program_name.empty())
+    {
+        return "";
+    }
+#ifdef _WIN32
+    return program_name;
+#else
+    if (program_name.find('/') != std::string::npos)
+    {
+        return access(program_name.c_str(), X_OK) == 0 ? program_name : "";
+    }
+
+    std::string path_env = getEnv("PATH");
+    size_t begin = 0;
+    while (begin <= path_env.size())
+    {
+        size_t end = path_env.find(':', begin);
+        if (end == std::string::npos)
+        {
+            end = path_env.size();
+        }
+        std::string dir = path_env.substr(begin, end - begin);
+        std::string program_path = (dir.empty() ? "." : dir) + "/" + program_name;
+        if (access(program_path.c_str(), X_OK) == 0)
+        {
+            return program_path;
+        }
+        begin = end + 1;
+    }
+    return "";
+#endif
+}
+
 std::string SystemUtils::getEnv(const std::string &env)
 {
     char *pEnv = getenv(env.c_str());
@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CommandLineArgs.h"
+
+static int s_failures = 0;
+
+static void expect(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", what.c_str());
+        ++s_failures;
+    }
+}
+
+static CommandLineArgs parse(std::vector<std::string> args)
+{
+    std::vector<char *> argv;
+    for (std::string &arg : args)
+    {
+        argv.push_back(&arg[0]);
+    }
+    CommandLineArgs parsed("cmake_tool build", static_cast<int>(argv.size()), argv.data());
+    parsed.addOption("--cache", "-c");
+    parsed.addOption("--remote-cache", "-r");
+    parsed.addOption("--jobs", "-j");
+    return parsed;
+}
+
+int main()
+{
+    // a flag followed by valued options: every option gets its own value
+    CommandLineArgs flag_first = parse({"build", "app", "-c", "-r", "http://host:8080", "-j", "4"});
+    expect(flag_first.value("-c") == "enable", "-c is a flag");
+    expect(flag_first.value("-r") == "http://host:8080", "-r keeps its URL, got \"" + flag_first.value("-r") + "\"");
+    expect(flag_first.value("-j") == "4", "-j keeps its count, got \"" + flag_first.value("-j") + "\"");
+    expect(flag_first.getPackagePaths() == std::vector<std::string>{"app"}, "app is the only package");
+
+    // valued options in any order
+    CommandLineArgs valued_first = parse({"build", "app", "-j", "4", "-r", "http://host:8080", "-c"});
+    expect(valued_first.value("-j") == "4", "-j before -r");
+    expect(valued_first.value("-r") == "http://host:8080", "-r before -c");
+    expect(valued_first.exists("-c"), "-c at the end");
+
+    // no options: all positionals are packages
+    CommandLineArgs packages = parse({"build", "app", "lib"});
+    expect(packages.getPackagePaths() == std::vector<std::string>{"app", "lib"}, "two packages");
+    expect(!packages.exists("-c") && !packages.exists("-j"), "no option set");
+
+    // help lines are not cut off, however long the description
+    std::string description = "comma separated build types built side by side, e.g. 'Debug,Release', installed to '<package>/install/<config>'. [default = none]";
+    CommandLineArgs help = parse({"build", "app"});
+    help.addOption("--configs", "-cf", false, description);
+    help.prepare();
+    std::ostringstream help_text;
+    std::streambuf *cout_buffer = std::cout.rdbuf(help_text.rdbuf());
+    help.printHelp();
+    std::cout.rdbuf(cout_buffer);
+    expect(help_text.str().find("--configs [-cf]:") != std::string::npos, "option in the help");
+    expect(help_text.str().find(description + "\n") != std::string::npos, "whole description in the help");
+
+    if (s_failures == 0)
+    {
+        printf("All CommandLineArgs tests passed\n");
+    }
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "utils/FileUtils.h"
+#include "utils/JsonStreamParser.h"
+
+static int s_failures = 0;
+
+static void expect(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", what.c_str());
+        ++s_failures;
+    }
+}
+
+typedef JsonStreamParser::Token Token;
+
+// all tokens of the JSON text up to END or ERROR
+static std::vector<Token> tokenize(const std::string &json, std::vector<std::string> *values = nullptr)
+{
+    std::string path = FileUtils::createTemporaryFilePath(".json");
+    FileUtils::writeFileContents(path, json);
+    std::vector<Token> tokens;
+    JsonStreamParser parser;
+    if (parser.open(path))
+    {
+        Token token;
+        do
+        {
+            token = parser.next();
+            tokens.push_back(token);
+            if (values != nullptr)
+            {
+                values->push_back(parser.value());
+            }
+        } while (token != Token::END && token != Token::ERROR);
+    }
+    FileUtils::deleteFile(path);
+    return tokens;
+}
+
+int main()
+{
+    // an object as written by -ftime-trace
+    std::vector<std::string> values;
+    std::vector<Token> tokens = tokenize("{\"traceEvents\": [{\"name\": \"Source\", \"dur\": 1250, \"ph\": \"X\"}], \"beginningOfTime\": null}", &values);
+    std::vector<Token> expected = {Token::OBJECT_BEGIN, Token::KEY, Token::ARRAY_BEGIN, Token::OBJECT_BEGIN,
+                                   Token::KEY, Token::STRING, Token::KEY, Token::NUMBER, Token::KEY, Token::STRING,
+                                   Token::OBJECT_END, Token::ARRAY_END, Token::KEY, Token::NULL_VALUE, Token::OBJECT_END, Token::END};
+    expect(tokens == expected, "time trace tokens");
+    expect(values.size() > 7 && values[1] == "traceEvents" && values[5] == "Source" && values[7] == "1250", "time trace values");
+
+    // escapes are decoded, \u as UTF-8 including surrogate pairs
+    values.clear();
+    tokens = tokenize("[\"a\\\"b\\\\c\\n\", \"\\u00e9\\ud83d\\ude00\", true, -1.5e3]", &values);
+    expect(tokens.size() == 7 && tokens[4] == Token::NUMBER, "array of scalars");
+    expect(values.size() > 4 && values[1] == "a\"b\\c\n", "simple escapes");
+    expect(values.size() > 4 && values[2] == "\xc3\xa9\xf0\x9f\x98\x80", "unicode escapes");
+    expect(values.size() > 4 && values[3] == "true" && values[4] == "-1.5e3", "boolean and number text");
+
+    // a string longer than the read buffer crosses chunk boundaries
+    std::string long_string(200 * 1024, 'x');
+    values.clear();
+    tokens = tokenize("{\"name\": \"" + long_string + "\"}", &values);
+    expect(tokens.size() == 5 && tokens[2] == Token::STRING && values[2] == long_string, "string across read chunks");
+
+    // skipValue steps over a nested value and keeps the depth
+    std::string path = FileUtils::createTemporaryFilePath(".json");
+    FileUtils::writeFileContents(path, "{\"skip\": {\"a\": [1, [2, {\"b\": 3}]]}, \"keep\": 4}");
+    JsonStreamParser parser;
+    expect(parser.open(path), "open");
+    expect(parser.next() == Token::OBJECT_BEGIN && parser.next() == Token::KEY && parser.value() == "skip", "first key");
+    expect(parser.skipValue() && parser.depth() == 1, "skip nested value");
+    expect(parser.next() == Token::KEY && parser.value() == "keep", "key after the skipped value");
+    expect(parser.next() == Token::NUMBER && parser.value() == "4", "value after the skipped value");
+    FileUtils::deleteFile(path);
+
+    // malformed input ends in ERROR instead of END
+    expect(tokenize("{\"a\" 1}").back() == Token::ERROR, "missing colon");
+    expect(tokenize("[1}").back() == Token::ERROR, "mismatched bracket");
+    expect(tokenize("[1, 2").back() == Token::ERROR, "unterminated array");
+    expect(tokenize("\"open").back() == Token::ERROR, "unterminated string");
+
+    if (s_failures == 0)
+    {
+        printf("All JsonStreamParser tests passed\n");
+    }
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "TemplateEngine.hpp"
+#include "utils/FileUtils.h"
+
+static int s_failures = 0;
+
+static void expect(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", what.c_str());
+        ++s_failures;
+    }
+}
+
+static std::string render(const std::string &text, const TemplateEngine::Variables &variables)
+{
+    TemplateEngine::Template parsed;
+    parsed.parse(text);
+    return parsed.render(variables);
+}
+
+int main()
+{
+    TemplateEngine::Variables variables = {{"PROJECT_NAME", "demo"}, {"CXX_STANDARD", "17"}, {"EMPTY", ""}};
+
+    // variables are replaced, everything else is kept as written
+    expect(render("project(%%PROJECT_NAME%%)\nset(CMAKE_CXX_STANDARD %%CXX_STANDARD%%)\n", variables) ==
+               "project(demo)\nset(CMAKE_CXX_STANDARD 17)\n", "variables replaced");
+    expect(render("%%PROJECT_NAME%%%%PROJECT_NAME%%", variables) == "demodemo", "adjacent variables");
+    expect(render("a%%EMPTY%%b", variables) == "ab", "empty value");
+    expect(render("%%UNKNOWN%% stays", variables) == "%%UNKNOWN%% stays", "unknown variable stays");
+    expect(render("", variables).empty(), "empty template");
+
+    // '%%' that does not enclose a variable name is literal
+    expect(render("printf(\"100%%\\n\"); %%PROJECT_NAME%%", variables) == "printf(\"100%%\\n\"); demo", "printf format");
+    expect(render("%%lower%% %%PROJECT_NAME", variables) == "%%lower%% %%PROJECT_NAME", "no variable name");
+    expect(render("%%%PROJECT_NAME%%%", variables) == "%demo%", "extra percent signs");
+
+    // a tree renders '.in' files, copies the others and expands variables in paths
+    std::string template_dir = FileUtils::createTemporaryFilePath();
+    std::string output_dir = FileUtils::createTemporaryFilePath();
+    FileUtils::createDirectory(FileUtils::buildFilePath(template_dir, "src"));
+    FileUtils::writeFileContents(FileUtils::buildFilePath(template_dir, "CMakeLists.txt.in"), "project(%%PROJECT_NAME%%)\n");
+    FileUtils::writeFileContents(FileUtils::buildFilePath(template_dir, "src/%%PROJECT_NAME%%.cpp.in"), "// %%PROJECT_NAME%%\n");
+    FileUtils::writeFileContents(FileUtils::buildFilePath(template_dir, "README"), "%%PROJECT_NAME%%\n");
+
+    TemplateEngine engine;
+    std::vector<std::string> written = engine.renderTree(template_dir, output_dir, variables);
+    expect(written.size() == 3, "three files written");
+    expect(FileUtils::getFileContents(FileUtils::buildFilePath(output_dir, "CMakeLists.txt")) == "project(demo)\n", "rendered file");
+    expect(FileUtils::getFileContents(FileUtils::buildFilePath(output_dir, "src/demo.cpp")) == "// demo\n", "variable in path");
+    expect(FileUtils::getFileContents(FileUtils::buildFilePath(output_dir, "README")) == "%%PROJECT_NAME%%\n", "copied file");
+
+    // templates are parsed once and kept
+    std::string cmake_template = FileUtils::buildFilePath(template_dir, "CMakeLists.txt.in");
+    const TemplateEngine::Template *loaded = engine.load(cmake_template);
+    expect(loaded != nullptr && loaded == engine.load(cmake_template), "template kept after load");
+    expect(engine.load(FileUtils::buildFilePath(template_dir, "missing.in")) == nullptr, "missing template");
+
+    FileUtils::deleteFolder(template_dir);
+    FileUtils::deleteFolder(output_dir);
+
+    if (s_failures == 0)
+    {
+        printf("All TemplateEngine tests passed\n");
+    }
+    return s_failures == 0 ? 0 : 1;
+}